@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace binaural {
+
+/// 缓存行对齐分配器，用于 SIMD 内核读写的 float 数组。
+/// 经由普通 operator new 多分配 Align 字节后手动对齐，原始指针存在对齐块之前，
+/// 因而同样受 RealtimeScope 分配检查约束
+template <typename T, std::size_t Align = 64>
+class AlignedAllocator {
+    static_assert((Align & (Align - 1)) == 0, "Align must be a power of two");
+    static_assert(Align >= sizeof(void*), "Align too small");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        void* raw = ::operator new(n * sizeof(T) + Align);
+        const auto addr = reinterpret_cast<std::uintptr_t>(raw) + Align;
+        void* aligned = reinterpret_cast<void*>(addr & ~(Align - 1));
+        static_cast<void**>(aligned)[-1] = raw;
+        return static_cast<T*>(aligned);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        if (p) ::operator delete(reinterpret_cast<void**>(p)[-1]);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const noexcept {
+        return false;
+    }
+};
+
+}  // namespace binaural
@@ -1,14 +1,16 @@
 #pragma once
 
+#include "audioStats.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
-#include <vector>
 
 namespace binaural {
 
-/// 音频驱动抽象：请求填充 bufferFrames 帧立体声样本
-using AudioCallback = std::function<void(std::vector<int16_t>&)>;
+/// 音频驱动抽象：请求向 samples 填充 frames 帧交错立体声样本。
+/// 实时驱动直接传入设备缓冲，回调须实时安全（不加锁、不分配）
+using AudioCallback = std::function<void(int16_t* samples, size_t frames)>;
 
 class IAudioDriver {
 public:
@@ -16,6 +18,8 @@ public:
     virtual bool start(int sampleRate, int bufferFrames, AudioCallback cb) = 0;
     virtual void stop() = 0;
     virtual bool isRunning() const = 0;
+    /// 回调耗时与 xrun 统计，可在任意线程轮询；不做实时回调的驱动返回 nullptr
+    virtual const AudioStats* stats() const { return nullptr; }
 };
 
 std::unique_ptr<IAudioDriver> createPortAudioDriver();
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace binaural {
+
+/// 某一时刻的统计快照（各字段分别读取，彼此之间不保证同一回调）
+struct AudioStatsSnapshot {
+    static constexpr size_t BUCKETS = 16;
+
+    uint64_t callbacks = 0;
+    uint64_t underflows = 0;      ///< 驱动报告的输出欠载
+    uint64_t overflows = 0;       ///< 驱动报告的输出溢出
+    uint64_t deadlineMisses = 0;  ///< 渲染耗时超过预算的回调
+    double budgetUs = 0;          ///< 最近一次回调的预算 frameCount / sampleRate
+    double lastRenderUs = 0;
+    double maxRenderUs = 0;
+    double load = 0;     ///< DSP 负载（渲染耗时 / 预算）的指数平均，1 = 100%
+    double maxLoad = 0;
+    /// 渲染耗时直方图：第 b 桶为 [2^b, 2^(b+1)) µs，首桶从 0 起，末桶含更长
+    std::array<uint64_t, BUCKETS> histogram{};
+
+    uint64_t xruns() const { return underflows + overflows; }
+};
+
+/// 音频回调的截止时间统计。回调线程每个 buffer 调用一次 record（单写者，
+/// 只有 relaxed 原子操作，不加锁、不分配），CLI / GUI 随时轮询 snapshot
+class AudioStats {
+public:
+    static constexpr size_t BUCKETS = AudioStatsSnapshot::BUCKETS;
+
+    /// renderNs 为本次回调的渲染耗时，budgetNs 为本 buffer 的播放时长
+    void record(uint64_t renderNs, uint64_t budgetNs, bool underflow,
+                bool overflow);
+    AudioStatsSnapshot snapshot() const;
+    /// 清零（非实时线程调用；与 record 并发时个别计数可能残留）
+    void reset();
+
+    /// 耗时所在的直方图桶
+    static size_t bucketOf(uint64_t renderNs);
+
+private:
+    std::atomic<uint64_t> callbacks_{0};
+    std::atomic<uint64_t> underflows_{0};
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> budgetNs_{0};
+    std::atomic<uint64_t> lastRenderNs_{0};
+    std::atomic<uint64_t> maxRenderNs_{0};
+    std::atomic<float> load_{0.f};
+    std::atomic<float> maxLoad_{0.f};
+    std::array<std::atomic<uint64_t>, BUCKETS> histogram_{};
+};
+
+}  // namespace binaural
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace binaural {
+
+/// 定长 16-bit PCM WAV 的内存映射写入：create 时按帧数预分配整个文件并
+/// 映射，头部一次写好，样本由调用方（如 OfflineRenderer 的各线程）
+/// 直接渲染进 samples() 指向的映射区，无中间缓冲与 write 拷贝。
+/// POSIX 用 posix_fallocate + mmap，Windows 用 CreateFileMapping
+class MappedWavFile {
+public:
+    MappedWavFile() = default;
+    /// 未 close 时自动 close
+    ~MappedWavFile();
+    MappedWavFile(const MappedWavFile&) = delete;
+    MappedWavFile& operator=(const MappedWavFile&) = delete;
+
+    /// 创建 frames 帧的文件并映射；frames 为 0 或空间不足时返回 false
+    bool create(const std::string& path, int sampleRate, uint64_t frames,
+                int channels = 2);
+    /// 解除映射并关闭文件；数据由系统回写，失败返回 false
+    bool close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    uint64_t frames() const { return frames_; }
+    /// frames() * channels 个交错样本，仅 create 成功后有效
+    int16_t* samples() const;
+
+private:
+    void release();
+
+    char* data_ = nullptr;
+    uint64_t size_ = 0;
+    uint64_t frames_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+}  // namespace binaural
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "period.hpp"
+#include "renderCache.hpp"
+#include "synthesizer.hpp"
+#include "writePipeline.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace binaural {
+
+/// 离线渲染整个 Program，按 buffer 对齐的时间块分给多个线程。
+/// 每块用 Synthesizer::seekProgram O(1) 定位到块起点再开始渲染，
+/// 结果与 renderSerial（即实时回调的逐 buffer 流程）逐样本一致。
+/// 输出长度按样本数精确等于各 period 时长之和，最后一个 buffer 可以不满
+class OfflineRenderer {
+public:
+    OfflineRenderer(const Program& program, const SynthesizerConfig& config);
+
+    /// 总帧数：所有 period 时长之和
+    uint64_t totalFrames() const { return totalFrames_; }
+    /// 覆盖 totalFrames() 的 buffer 数（向上取整）
+    uint64_t totalBuffers() const { return totalBuffers_; }
+
+    /// 渲染全部帧到 out（totalFrames() * 2 个交错样本）。
+    /// threads <= 0 使用 std::thread::hardware_concurrency()
+    void render(int16_t* out, int threads = 0) const;
+    /// 单线程参考实现
+    void renderSerial(int16_t* out) const;
+
+    /// 便捷版本，返回 totalFrames() 帧交错样本
+    std::vector<int16_t> render(int threads = 0) const;
+
+    /// 接收按时间顺序渲染好的交错样本，返回 false 时中止渲染
+    using Sink = std::function<bool(const int16_t* samples, size_t frames)>;
+    /// 流式渲染：每次并行渲染 WINDOW_BUFFERS 个 buffer，经 WritePipeline
+    /// 在独立写线程上按顺序交给 sink，渲染与写入重叠，内存占用与时长无关。
+    /// sink 中止时返回 false；stats 非空时写入吞吐统计
+    bool render(const Sink& sink, int threads = 0,
+                ExportStats* stats = nullptr) const;
+
+    static constexpr uint64_t WINDOW_BUFFERS = 1024;
+
+    /// 启用磁盘缓存：render 按 period 区间读取已缓存的样本，未命中的区间
+    /// 渲染后写入。nullptr 关闭；cache 须在 renderer 使用期间有效
+    void setCache(RenderCache* cache);
+
+private:
+    /// 一个 period 的输出区间（帧）与其缓存键
+    struct CachedSegment {
+        uint64_t first;
+        uint64_t count;
+        std::string key;
+    };
+    /// 一次 render 调用中正在写入缓存的区间
+    struct CacheSession {
+        RenderCache::Writer writer;
+        size_t segment = SIZE_MAX;
+    };
+
+    /// 渲染帧区间 [first, first + count)，启用缓存时按区间读写缓存
+    void renderCached(uint64_t first, uint64_t count, int16_t* out,
+                      int threads, CacheSession& session) const;
+    /// 多线程渲染帧区间 [first, first + count)，按整 buffer 分块
+    void renderRange(uint64_t first, uint64_t count, int16_t* out,
+                     int threads) const;
+    /// 渲染帧区间 [first, first + count)，out 指向 first 对应的位置
+    void renderFrames(uint64_t first, uint64_t count, int16_t* out) const;
+
+    Program program_;
+    SynthesizerConfig config_;
+    uint64_t totalFrames_ = 0;
+    uint64_t totalBuffers_ = 0;
+    RenderCache* cache_ = nullptr;
+    std::vector<CachedSegment> segments_;
+};
+
+}  // namespace binaural
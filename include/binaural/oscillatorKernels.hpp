@@ -0,0 +1,99 @@
+#pragma once
+
+#include "phaseModel.hpp"
+
+namespace binaural {
+
+class SinTable;
+
+/// 振荡器内核指令集；Auto 在运行时检测当前 CPU 支持的最佳实现
+enum class SimdLevel { Auto, Scalar, Sse2, Avx2, Neon };
+
+/// 多项式正弦的精度档位，阶数越高越慢。正弦最大绝对误差见 kernels::maxSineError。
+/// THD/SINAD 为 687 Hz（非二进制频率，含 float 相位舍入）实测值：
+/// Draft：约 -71 dB / 71 dB，适合离线批量导出
+/// Standard：约 -104 dB / 103 dB
+/// Reference：约 -159 dB / 110 dB，SINAD 受 float 相位舍入限制，不再受正弦
+///            近似限制；实时播放默认使用
+enum class QualityTier { Draft, Standard, Reference };
+
+/// 正弦振荡器后端
+/// Polynomial：按 QualityTier 选择的 minimax 多项式，按 SimdLevel 向量化
+/// Libm：逐帧 std::sin 参考实现，块内相位按原 fillSamples 的方式逐帧 float
+///       累加，不受 SimdLevel/QualityTier 影响
+/// Table：SinTable::sinFastFloat 线性插值查表
+/// FixedPoint：32 位定点相位累加器 + 查表，相位回绕由整数溢出完成
+enum class OscillatorBackend { Polynomial, Libm, Table, FixedPoint };
+
+const char* oscillatorBackendName(OscillatorBackend backend);
+const char* qualityTierName(QualityTier tier);
+
+namespace kernels {
+
+using phase::Ramp;
+
+/// 双耳 voice：outL += sin(2π·l(k))·vol，outR 同理，l(k) 为 Ramp 的第 k 帧
+/// 相位（单位为周期，扫频时逐帧二次变化）
+using BinauralFn = void (*)(float* outL, float* outR, int numFrames,
+                            const Ramp& l, const Ramp& r, float vol);
+
+/// 等时 voice：载波 carrier，按 iso 的前半周期 cos 包络脉冲，左右声道相同
+using IsochronicFn = void (*)(float* outL, float* outR, int numFrames,
+                              const Ramp& carrier, const Ramp& iso,
+                              float vol);
+
+struct KernelSet {
+    SimdLevel level;
+    QualityTier tier;
+    BinauralFn binaural;
+    IsochronicFn isochronic;
+};
+
+/// Reference 档内核相对 binauralLibm/isochronicLibm 的最大绝对误差（vol = 1，
+/// 每 voice，块长至多 2048 帧）。主要来自参考实现逐帧累加相位的舍入：
+/// 每帧至多 2^-25 周期，2048 帧约 2048·2^-25·2π ≈ 3.8e-4
+constexpr float MAX_VECTOR_ERROR = 4e-4f;
+
+/// 各档 sin2Pi 相对精确正弦的最大绝对误差上界（float 求值，含舍入）
+float maxSineError(QualityTier tier);
+
+/// 标量多项式 sin(2π·phase)，与同档内核逐帧结果一致（FMA 舍入差异除外）
+float sin2Pi(QualityTier tier, float phase);
+
+/// 检测当前 CPU 可用的最佳指令集（结果已缓存）
+SimdLevel detectSimdLevel();
+
+/// Auto 或当前 CPU 不支持的指令集回退到 detectSimdLevel() 的结果
+SimdLevel resolveSimdLevel(SimdLevel requested);
+
+const char* simdLevelName(SimdLevel level);
+
+/// 多项式内核；Scalar 逐帧计算，Sse2/Avx2/Neon 4/8 帧一组
+const KernelSet& selectKernels(SimdLevel level,
+                               QualityTier tier = QualityTier::Reference);
+
+/// std::sin 参考实现，参数语义同 BinauralFn/IsochronicFn。块内相位从
+/// Ramp::start 起逐帧累加（与原 fillSamples 相同），而非按 phaseAt 闭式求值
+void binauralLibm(float* outL, float* outR, int numFrames, const Ramp& l,
+                  const Ramp& r, float vol);
+void isochronicLibm(float* outL, float* outR, int numFrames,
+                    const Ramp& carrier, const Ramp& iso, float vol);
+
+/// 查表后端，参数语义同 BinauralFn/IsochronicFn
+void binauralTable(const SinTable& table, float* outL, float* outR,
+                   int numFrames, const Ramp& l, const Ramp& r, float vol);
+void isochronicTable(const SinTable& table, float* outL, float* outR,
+                     int numFrames, const Ramp& carrier, const Ramp& iso,
+                     float vol);
+
+/// 定点后端，table 须为 2 的幂长度；相位按 64 位定点逐帧累加
+void binauralFixedPoint(const SinTable& table, float* outL, float* outR,
+                        int numFrames, const Ramp& l, const Ramp& r,
+                        float vol);
+void isochronicFixedPoint(const SinTable& table, float* outL, float* outR,
+                          int numFrames, const Ramp& carrier, const Ramp& iso,
+                          float vol);
+
+}  // namespace kernels
+
+}  // namespace binaural
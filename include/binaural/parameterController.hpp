@@ -9,8 +9,8 @@
 namespace binaural {
 
 /// 参数控制层：轮询预测队列，应用 Ramping 引导策略，更新合成器频率
-/// 每 50ms 轮询取最新预测；有预测时用 targetBeatFreq 渐变，无预测时用 program
-/// skewVoices
+/// 每 50ms 轮询取最新预测；有预测时用 targetBeatFreq 渐变，无预测时回到
+/// program 日程（resumeSchedule）
 class ParameterController {
 public:
   using PredictionQueue = LockFreeQueue<EEGStatePrediction, 8>;
@@ -18,7 +18,7 @@ public:
   explicit ParameterController(Synthesizer &synth, PredictionQueue &queue);
 
   /// 在音频回调中调用（或控制线程每 buffer）：轮询队列，更新 freqs
-  void update(float periodElapsedSec);
+  void update();
 
   /// 是否当前由 AI 预测驱动（用于 UI 显示）
   bool isAiDriven() const { return aiDriven_.load(std::memory_order_acquire); }
@@ -36,6 +36,9 @@ public:
   }
 
 private:
+  /// 此前 setAllFreqs 覆盖过节拍时交还 program 日程
+  void resumeSchedule();
+
   Synthesizer *synth_;
   PredictionQueue *queue_;
   float currentTargetHz_ = 0.f;
@@ -43,6 +46,7 @@ private:
   std::atomic<bool> clearRequested_{false};
   float rampRate_ = 2.0f;
   std::optional<EEGStatePrediction> lastPrediction_;
+  bool overriding_ = false;
 };
 
 } // namespace binaural
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace binaural {
+
+/// 一次节拍频率写入：回到 program 日程、按 voice 下标各自设置，或全部相同
+struct BeatOverride {
+    static constexpr size_t MAX_VOICES = 32;
+    enum class Kind : uint8_t { Schedule, PerVoice, All };
+
+    Kind kind = Kind::Schedule;
+    uint32_t count = 0;  ///< PerVoice 时有效的 hz 个数；All 时为 1
+    float hz[MAX_VOICES] = {};
+};
+
+/// 实时参数信箱：控制线程写入，音频线程在 buffer 边界读取，双方都不加锁、
+/// 不等待。音量、声像与 seek 请求各为一个原子值，任意线程可写；节拍写入是
+/// seqlock 保护的定长块，限单个写线程，读者遇到写入进行中时放弃本次、
+/// 下个 buffer 再取
+class ParameterMailbox {
+public:
+    void setVolume(float v) { volume_.store(v, std::memory_order_relaxed); }
+    float volume() const { return volume_.load(std::memory_order_relaxed); }
+    void setBalance(float b) { balance_.store(b, std::memory_order_relaxed); }
+    float balance() const { return balance_.load(std::memory_order_relaxed); }
+
+    /// 请求 seek 到当前 period 内第 sec 秒，覆盖尚未取走的上一次请求
+    void postSeek(double sec) {
+        seekSec_.store(sec > 0.0 ? sec : 0.0, std::memory_order_relaxed);
+    }
+
+    /// 音频线程：有待处理的 seek 请求时取走并返回 true
+    bool takeSeek(double& sec) {
+        if (seekSec_.load(std::memory_order_relaxed) < 0.0) return false;
+        sec = seekSec_.exchange(-1.0, std::memory_order_relaxed);
+        return sec >= 0.0;
+    }
+
+    /// 写入节拍（单写者），覆盖尚未取走的上一次写入
+    void postBeats(const BeatOverride& beats) {
+        const uint32_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        kind_.store(beats.kind, std::memory_order_relaxed);
+        const uint32_t count =
+            beats.count < BeatOverride::MAX_VOICES
+                ? beats.count
+                : static_cast<uint32_t>(BeatOverride::MAX_VOICES);
+        count_.store(count, std::memory_order_relaxed);
+        for (uint32_t j = 0; j < count; ++j)
+            hz_[j].store(beats.hz[j], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    /// 音频线程：有未取走的写入且读到一致快照时复制到 out 并返回 true
+    bool takeBeats(BeatOverride& out) {
+        const uint32_t s = seq_.load(std::memory_order_acquire);
+        if (s == seen_ || (s & 1u)) return false;
+        out.kind = kind_.load(std::memory_order_relaxed);
+        out.count = count_.load(std::memory_order_relaxed);
+        for (uint32_t j = 0; j < out.count; ++j)
+            out.hz[j] = hz_[j].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != s) return false;
+        seen_ = s;
+        return true;
+    }
+
+    /// 音频线程：丢弃已完成、尚未取走的写入；进行中的写入完成后仍会取到
+    void discardBeats() {
+        seen_ = seq_.load(std::memory_order_acquire) & ~1u;
+    }
+
+private:
+    std::atomic<float> volume_{1.f};
+    std::atomic<float> balance_{0.f};
+    std::atomic<double> seekSec_{-1.0};  // 负值表示没有待处理的请求
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<BeatOverride::Kind> kind_{BeatOverride::Kind::Schedule};
+    std::atomic<uint32_t> count_{0};
+    std::atomic<float> hz_[BeatOverride::MAX_VOICES] = {};
+    uint32_t seen_ = 0;  // 读者私有
+};
+
+}  // namespace binaural
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "voice.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -8,12 +11,17 @@ namespace binaural {
 
 struct Period {
     enum class Background { None, WhiteNoise, PinkNoise };
-    int lengthSec = 0;
+    double lengthSec = 0;  // 可为小数，播放时按样本数计
     std::vector<BinauralBeatVoice> voices;
     Background background = Background::None;
     float backgroundVol = 0.f;
 };
 
+/// period 的样本数（时长四舍五入到整帧），时间线与导出长度都以此为准
+inline int64_t periodFrames(const Period& period, int sampleRate) {
+    return std::llround(std::max(period.lengthSec, 0.0) * sampleRate);
+}
+
 struct Program {
     std::string name;
     std::vector<Period> seq;
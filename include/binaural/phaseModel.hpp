@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cmath>
+
+namespace binaural {
+
+/// 振荡器相位的闭式解。频率在锚点后随帧线性变化：f(d) = hz + slope·d
+/// （slope 单位 Hz/帧，常量频率为 slope = 0），相位为 d 的二次式。
+/// 相位只取决于锚点状态与帧位置，不随渲染逐块累加，可 O(1) 跳到任意帧
+namespace phase {
+
+/// 从锚点起 d 帧的相位增量（周期数），d 可为负
+inline double cycles(double hz, double slope, double d, double sampleRate) {
+    return (hz + 0.5 * slope * d) * d / sampleRate;
+}
+
+/// 取小数部分，[0, 1)
+inline double wrap(double p) { return p - std::floor(p); }
+
+/// 块内相位：内核第 k 帧取 start + k·(inc + k·curve)，即步进从 inc + curve
+/// 起每帧增加 2·curve。常量频率时 curve = 0
+struct Ramp {
+    float start;
+    float inc;
+    float curve;
+};
+
+/// 锚点相位为 phase 的振荡器从锚点后第 d0 帧起的块内相位。频率线性变化时
+/// 相位是帧的二次式，块内逐帧与闭式解一致（float 舍入以内），与块长无关
+inline Ramp ramp(double phase, double hz, double slope, double d0,
+                 double sampleRate) {
+    const double p0 = phase + cycles(hz, slope, d0, sampleRate);
+    return {static_cast<float>(wrap(p0)),
+            static_cast<float>((hz + slope * d0) / sampleRate),
+            static_cast<float>(0.5 * slope / sampleRate)};
+}
+
+}  // namespace phase
+
+}  // namespace binaural
@@ -1,19 +1,27 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace binaural {
 
-/// Trammell 粉红噪声 (1/f)，用于背景掩蔽
+/// Trammell 粉红噪声 (1/f)，用于背景掩蔽。
+/// 三级滤波各用一路计数器式随机数（见 whiteNoise.hpp），
+/// generate() 整块生成随机数并分段求解滤波递推，与逐个 tick() 仅差 float 舍入
 class PinkNoise {
 public:
-    PinkNoise();
+    explicit PinkNoise(uint32_t seed = 1u);
     void clear();
     float tick();
+    void generate(float* out, size_t n);
+    /// 随机数流定位到第 sample 个样本；滤波状态不变
+    void seek(uint64_t sample) { counter_ = sample; }
 
 private:
     static constexpr int NUM_STAGES = 3;
     float state_[NUM_STAGES];
-    unsigned int seed_;
-    static float randFloat(unsigned int& seed);
+    uint32_t keys_[NUM_STAGES];
+    uint64_t counter_ = 0;
 };
 
 }  // namespace binaural
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "synthesizer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace binaural {
+
+/// UI 线程向音频线程交接 program 的无锁信箱（RCU 式）。
+/// publish 在调用线程上构建不可变的快照（Synthesizer::prepareProgram）并放入
+/// 待取槽，尚未取走的旧快照被直接替换；音频线程在每个 buffer 开始时调用
+/// apply，取到新快照则与 Synthesizer 交换状态。换下的旧状态挂到退役链表，
+/// 由后台回收线程释放：音频线程上没有锁、分配或释放。
+/// 单个发布线程、单个音频线程
+class ProgramExchange {
+public:
+    /// synth 只用于 prepareProgram（只读构造时的配置），须比本对象存活更久
+    explicit ProgramExchange(const Synthesizer& synth);
+    ~ProgramExchange();
+
+    ProgramExchange(const ProgramExchange&) = delete;
+    ProgramExchange& operator=(const ProgramExchange&) = delete;
+
+    /// 发布线程调用（非实时）：下一个 buffer 起改用 program，从起点播放。
+    /// continuous 为 true 时按参数编辑处理，布局不变则接着当前位置与相位
+    /// 播放（见 Synthesizer::PreparedProgram::continuous）
+    void publish(const Program& program, bool continuous = false);
+    /// 音频线程在 buffer 边界调用：有新快照时装入 synth 并返回 true。
+    /// 无锁、不分配、不释放
+    bool apply(Synthesizer& synth);
+    /// 立即释放已退役的状态（非实时）；回收线程也会定期调用
+    void reclaim();
+
+    /// 已发布 / 已装入 / 已释放的快照数，供诊断与基准
+    uint64_t published() const {
+        return published_.load(std::memory_order_relaxed);
+    }
+    uint64_t applied() const {
+        return applied_.load(std::memory_order_relaxed);
+    }
+    uint64_t reclaimed() const {
+        return reclaimed_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Node {
+        std::unique_ptr<Synthesizer::PreparedProgram> state;
+        Node* next = nullptr;
+    };
+
+    /// 压入退役链表（Treiber 栈，只有回收方整体取走，无 ABA）
+    void retire(Node* node);
+    /// 释放退役链表，调用方持有 reclaimMutex_
+    void drain();
+
+    const Synthesizer& synth_;
+    std::atomic<Node*> pending_{nullptr};
+    std::atomic<Node*> retired_{nullptr};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> applied_{0};
+    std::atomic<uint64_t> reclaimed_{0};
+
+    std::mutex reclaimMutex_;
+    std::condition_variable reclaimWake_;
+    bool stop_ = false;
+    std::thread reclaimer_;
+};
+
+}  // namespace binaural
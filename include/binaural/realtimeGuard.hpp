@@ -0,0 +1,23 @@
+#pragma once
+
+namespace binaural {
+
+/// 实时线程分配检查。Debug 构建（未定义 NDEBUG）下，RealtimeScope 存活期间
+/// 本线程的 operator new/delete 触发断言失败，用于证明音频回调零堆分配。
+/// Release 构建或定义 BINAURAL_NO_RT_ALLOC_CHECK 时为空操作
+class RealtimeScope {
+public:
+    RealtimeScope();
+    ~RealtimeScope();
+
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+};
+
+/// 当前构建是否启用了分配检查
+bool realtimeAllocCheckEnabled();
+
+/// 当前线程是否处于 RealtimeScope 内
+bool inRealtimeScope();
+
+}  // namespace binaural
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace binaural {
+
+/// 命中与未命中按 read 调用计（流式导出每个窗口读一次）
+struct RenderCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t evictions = 0;
+};
+
+/// 磁盘上的内容寻址渲染缓存：键为决定一段输出的全部状态的规范字节序列
+/// （见 Synthesizer::segmentKey），文件名为键的 FNV-1a 哈希。
+/// 每个条目一个文件：固定头部 + 完整键（读取时逐字节核对，哈希碰撞视为未命中）
+/// + 按 64 字节对齐的交错 16-bit 样本，可直接 mmap。
+/// 命中时刷新文件修改时间，写入新条目后按修改时间 LRU 淘汰到容量以内。
+/// 非线程安全，由渲染的调用线程使用
+class RenderCache {
+public:
+    static constexpr uint64_t DEFAULT_MAX_BYTES = 2048ull << 20;
+
+    /// 逐段写入一个条目：append 累计到 frames 帧后 commit 才对读取可见，
+    /// 未 commit 即析构时丢弃
+    class Writer {
+    public:
+        Writer() = default;
+        ~Writer();
+        Writer(Writer&& other) noexcept;
+        Writer& operator=(Writer&& other) noexcept;
+
+        bool isOpen() const { return file_.is_open(); }
+        uint64_t remaining() const { return remaining_; }
+        bool append(const int16_t* samples, size_t frames);
+        /// 写满 frames 帧后发布条目并淘汰旧条目；失败返回 false
+        bool commit();
+
+    private:
+        friend class RenderCache;
+        void discard();
+
+        RenderCache* cache_ = nullptr;
+        std::ofstream file_;
+        std::string tmpPath_;
+        std::string path_;
+        uint64_t remaining_ = 0;
+    };
+
+    /// dir 不存在时创建；maxBytes 为全部条目的总大小上限，已有条目超出时
+    /// 立即淘汰
+    explicit RenderCache(std::string dir, uint64_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /// 读取 key 条目中从第 offset 帧起 frames 帧到 out。条目不存在、键不符或
+    /// 长度不足时返回 false（计一次未命中）
+    bool read(const std::string& key, uint64_t offset, int16_t* out,
+              size_t frames);
+    /// 开始写入 frames 帧的 key 条目
+    Writer beginWrite(const std::string& key, uint64_t frames);
+
+    const RenderCacheStats& stats() const { return stats_; }
+    const std::string& directory() const { return dir_; }
+    uint64_t maxBytes() const { return maxBytes_; }
+    /// 当前全部条目的总字节数
+    uint64_t sizeBytes() const;
+
+    static uint64_t fnv1a(const std::string& bytes);
+
+private:
+    std::string pathOf(const std::string& key) const;
+    void evict(const std::string& keep);
+
+    std::string dir_;
+    uint64_t maxBytes_;
+    RenderCacheStats stats_;
+};
+
+}  // namespace binaural
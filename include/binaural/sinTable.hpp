@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 namespace binaural {
@@ -11,15 +13,39 @@ public:
 
     float sinFastInt(int angle) const;
     float cosFastInt(int angle) const;
-    /// phase in [0, 1) -> sin(2*pi*phase), 线性插值保证亚 Hz 精度
+    /// phase in [0, 1) -> sin(2*pi*phase), 线性插值保证亚 Hz 精度。
+    /// 表长为 2 的幂时用位掩码回绕，否则取模
     float sinFastFloat(float phase) const;
+    /// 32 位定点相位（2^32 对应一周期），要求表长为 2 的幂
+    float sinFixed(uint32_t phase) const;
 
-    int size() const { return static_cast<int>(tableSin_.size()); }
+    int size() const { return size_; }
+    bool isPowerOfTwo() const { return mask_ != 0; }
+
+    static int nextPowerOfTwo(int n);
 
 private:
-    std::vector<float> tableSin_;
+    std::vector<float> tableSin_;  // size_ + 1 项，末项等于首项，插值无需回绕
     std::vector<float> tableCos_;
     int size_;
+    int mask_ = 0;  // 2 的幂时为 size_ - 1
+    int bits_ = 0;  // log2(size_)
 };
 
+inline float SinTable::sinFastFloat(float phase) const {
+    phase -= std::floor(phase);
+    const float scaled = phase * static_cast<float>(size_);
+    const int whole = static_cast<int>(scaled);
+    const float frac = scaled - static_cast<float>(whole);
+    const int i0 = mask_ ? (whole & mask_) : (whole % size_);
+    return tableSin_[i0] + (tableSin_[i0 + 1] - tableSin_[i0]) * frac;
+}
+
+inline float SinTable::sinFixed(uint32_t phase) const {
+    const uint32_t i0 = phase >> (32 - bits_);
+    const float frac =
+        static_cast<float>(phase << bits_) * (1.0f / 4294967296.0f);
+    return tableSin_[i0] + (tableSin_[i0 + 1] - tableSin_[i0]) * frac;
+}
+
 }  // namespace binaural
@@ -1,8 +1,18 @@
 #pragma once
 
+#include "oscillatorKernels.hpp"
+#include "parameterMailbox.hpp"
 #include "period.hpp"
+#include "phaseModel.hpp"
 #include "pinkNoise.hpp"
+#include "sinTable.hpp"
+#include "voiceBank.hpp"
+#include "whiteNoise.hpp"
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace binaural {
@@ -10,54 +20,304 @@ namespace binaural {
 struct SynthesizerConfig {
     int sampleRate = 44100;
     int bufferFrames = 2048;
+    /// Table/FixedPoint 后端的正弦表长度，向上取整为 2 的幂
     int iscale = 1440;
+    /// 振荡器内核指令集（仅 Polynomial 后端）
+    SimdLevel simd = SimdLevel::Auto;
+    /// 多项式正弦精度（仅 Polynomial 后端）；离线导出可用 Draft 换取速度
+    QualityTier quality = QualityTier::Reference;
+    OscillatorBackend oscillator = OscillatorBackend::Polynomial;
+    /// 混音使用按背景噪声/声像编译期特化的循环；false 为逐样本分支的通用循环，
+    /// 仅供基准对比
+    bool specializedMix = true;
+    /// 相邻 period 之间的等功率交叉淡化时长（毫秒），0 为直接切换。
+    /// 上一 period 的 voice 按其日程延续到新 period 开头，不超过新 period 时长；
+    /// 背景噪声在切换点直接切换。program 起点（含循环回到开头）不淡化
+    int crossfadeMs = 0;
 };
 
+/// period 按样本数首尾相接，render 在切换点处切分，一个 buffer 内可以跨越
+/// 任意多个 period。相位、节拍日程、渐入渐出与噪声位置都是 (period, 帧) 的
+/// 函数：渲染按 bufferFrames 网格（从 program 起点计）分块，每块由锚点闭式求
+/// 相位，seek 到任意帧（含循环播放的第二轮及以后）后的输出与从头连续渲染
+/// 逐位一致
 class Synthesizer {
 public:
     explicit Synthesizer(const SynthesizerConfig& config = {});
 
+    /// 切换 program 并回到起点，等价于 adoptProgram(*prepareProgram(program))
     void setProgram(const Program& program);
+
+    /// setProgram 中需要分配内存的部分：program 副本、规范时间线，以及按其
+    /// 容量预分配的 voice 状态
+    struct PreparedProgram;
+    /// 只读取构造时确定的配置，可在其他线程与 render 并发调用（非实时）。
+    /// continuous 见 PreparedProgram::continuous
+    std::unique_ptr<PreparedProgram> prepareProgram(
+        const Program& program, bool continuous = false) const;
+    /// 实时安全的 setProgram：与 prepared 交换状态，不分配也不释放内存。
+    /// 返回后 prepared 持有原来的状态，由调用方在非实时线程释放
+    void adoptProgram(PreparedProgram& prepared);
+    // 以下参数写入 ParameterMailbox，下次 render 开始时生效，在
+    // PARAM_RAMP_MS 内逐样本线性过渡。音量与声像可在任意线程设置；
+    // 节拍频率限单个控制线程（通常就是音频回调本身）
+
+    /// 以常量节拍频率覆盖 program 日程，相位连续；最多前
+    /// BeatOverride::MAX_VOICES 个 voice
     void setFreqs(const std::vector<float>& freqs);
+    /// 不分配内存的版本
+    void setFreqs(const float* freqs, size_t n);
+    /// 当前 period 所有 voice 使用同一节拍频率
+    void setAllFreqs(float hz);
     void setVolumeMultiplier(float v);
     /// balance: -1=左, 0=中, 1=右
     void setBalance(float b);
-    void skewVoices(float periodElapsedSec);
+    /// 取消 setFreqs / setAllFreqs 覆盖，节拍频率回到 program 日程（每个 voice
+    /// 沿自己的 freqStart -> freqEnd 逐样本线性变化），相位连续
+    void resumeSchedule();
+
+    /// 参数变化后的线性过渡时长
+    static constexpr int PARAM_RAMP_MS = 20;
 
-    /// 填充立体声交错 16-bit 样本 [L0,R0,L1,R1,...]
+    /// 填充立体声交错 16-bit 样本 [L0,R0,L1,R1,...]，输出调整为 bufferFrames 帧
     void fillSamples(std::vector<int16_t>& outSamples);
 
+    /// 实时安全渲染：写入 frames 帧交错立体声，不做任何堆分配。
+    /// 暂存区在构造时按 bufferFrames 预分配，更长的请求分块渲染
+    void render(int16_t* out, size_t frames);
+    /// 同上，输出归一化到 [-1, 1)
+    void render(float* out, size_t frames);
+    /// 快进 frames 帧而不生成样本，O(跨越的 period 数)；之后的输出与一直
+    /// render 逐位一致
+    void skip(size_t frames);
+
+    /// O(1) 跳到第 periodIndex 个 period 内第 frame 帧。
+    /// 之后的输出与从 program 起点连续渲染（每 buffer 调用一次 advanceFrames）
+    /// 到该位置逐位一致；setFreqs 覆盖的节拍被丢弃，进行中的参数过渡直接到位
+    void seek(int periodIndex, uint64_t frame);
+    /// 按距 program 起点的帧数 seek。超出一轮时定位到所在轮次：相位取该轮的
+    /// 进入相位（与循环播放相同），噪声每轮从头开始
+    void seekProgram(uint64_t frame);
+
+    /// 规范时间线上一个 period 的输出区间，距 program 起点的帧数
+    struct Segment {
+        uint64_t begin;
+        uint64_t end;
+    };
+    /// 第 periodIndex 个 period 的区间；各 period 首尾相接，覆盖一轮 program
+    Segment segment(int periodIndex) const;
+    /// 该区间输出依赖的全部状态的规范字节序列：period 参数、影响输出的配置、
+    /// 进入位置与相位、粉红噪声段起点、音量与声像，交叉淡化时还有上一
+    /// period。两段键相同则输出逐位相同，供 RenderCache 作键（非实时）
+    std::string segmentKey(int periodIndex) const;
+
     const SynthesizerConfig& config() const { return config_; }
-    int currentPeriodIndex() const { return currentPeriodIndex_; }
-    float periodElapsedSec() const { return periodElapsedSec_; }
-    void advanceTime(float sec);
-    /// 设置当前 period 内已播放秒数（用于 seek），自动 clamp 到 [0, lengthSec]
-    void setPeriodElapsedSec(float sec);
+    /// Polynomial 后端实际使用的内核指令集（Auto 解析后的结果）
+    SimdLevel simdLevel() const { return kernels_->level; }
+    /// 播放时钟所在的 period。advanceFrames 与 seek 时发布（每 buffer 一次），
+    /// 可在任意线程读取
+    int currentPeriodIndex() const {
+        return shownPeriod_.load(std::memory_order_relaxed);
+    }
+    /// 由发布的整数帧位置换算，仅用于显示；不累加浮点时间。可在任意线程读取
+    double periodElapsedSec() const {
+        return static_cast<double>(
+                   shownFrame_.load(std::memory_order_relaxed)) /
+               config_.sampleRate;
+    }
+    /// 当前 period 内已播放帧数（音频线程）
+    uint64_t periodFrame() const { return static_cast<uint64_t>(periodFrame_); }
+    /// 播放时钟距 program 起点的帧数，[0, programFrames)（音频线程）
+    uint64_t programFrame() const;
+    /// 推进播放时钟 frames 帧（64 位样本计数，任意时长无漂移），可跨越
+    /// 任意多个 period。render 已按样本走到同一位置时无操作，否则渲染
+    /// 位置跟随时钟
+    void advanceFrames(uint64_t frames);
+    /// 设置当前 period 内已播放秒数（用于 seek）。请求写入信箱，可在任意
+    /// 线程调用；下次 render 开始时在音频线程上 seek 到届时所在 period 的
+    /// 该位置，clamp 到 [0, lengthSec]
+    void setPeriodElapsedSec(double sec);
 
     /// 当前 Period 指针，供参数控制层使用
     const Period* currentPeriod() const;
 
 private:
+    /// 规范时间线上的 period：起点与进入时各 voice 的锚点相位（按 voice
+    /// 下标存于 entryPhaseA_/B_）
+    struct PeriodEntry {
+        int64_t start;         ///< period 起点，距 program 起点的帧数
+        int64_t pinkRunStart;  ///< 所在连续粉红噪声段的滤波起算帧
+        size_t phaseOffset;
+    };
+    /// 第二轮起的进入相位。base 为第二轮各 period 的进入相位（下标同
+    /// entryPhaseA_）；每轮都延续的 voice（下标小于各 period 的最少 voice
+    /// 数，step 的长度）此后每轮再前进 step[j]，其余 voice 在轮内重建，
+    /// 各轮都与第二轮相同
+    struct LoopPhases {
+        std::vector<double> baseA;
+        std::vector<double> baseB;
+        std::vector<double> stepA;
+        std::vector<double> stepB;
+    };
+
     float voicetoPitch(int voiceIndex) const;
+    float pitchOf(const Period& period, int voice) const;
+    /// prepareProgram 时模拟一遍规范时间线，O(总 voice 数)
+    void buildTimeline(PreparedProgram& out) const;
+    /// 连续切换：第 periodIndex 个 period 的进入相位改为使第 frame 帧的相位
+    /// 等于 live 中同下标 voice 的相位（live 的锚点须在该帧），之后各 period
+    /// 按 buildTimeline 的运算重新推出。借用 voices_ 模拟，不分配
+    void rebaseTimeline(int periodIndex, int64_t frame, const VoiceBank& live);
+    /// bank 为最后一个 period 的进入状态（锚点在其起点），按 buildTimeline 的
+    /// 运算再模拟一轮，写入 loop（须已按 entryA 与最少 voice 数分配）。
+    /// entryA/B 中最后一个 period 的进入相位须与 bank 一致
+    void buildLoopPhases(const Program& program,
+                         const std::vector<PeriodEntry>& timeline,
+                         const std::vector<double>& entryA,
+                         const std::vector<double>& entryB, VoiceBank& bank,
+                         LoopPhases& loop) const;
+    /// 第 loop_ 轮第 periodIndex 个 period 的进入相位写入 bank
+    void loadEntryPhases(VoiceBank& bank, int periodIndex) const;
+    /// period 变化（或 setProgram 后）时按当前 period 重建 voices_
     void ensureStateSize();
+    /// 锚点移到 frame，之后节拍按日程变化
+    void applySchedule(VoiceBank& bank, const Period& period,
+                       int64_t frame) const;
+    void reanchor(int64_t frame);
+    /// 渲染位置到达当前 period 末尾时进入下一个，相位连续带入，可连续跨越
+    /// 多个 period（含零时长的）
+    void crossBoundaries();
+    void enterNextPeriod();
+    /// 定位到 periodIndex 内第 frame 帧，相位取规范时间线；seek 中不涉及
+    /// 信箱与参数过渡的部分
+    void locate(int periodIndex, int64_t frame);
+    /// 按规范时间线准备上一 period 的淡出 voice（未启用交叉淡化或在 program
+    /// 起点时清空）
+    void prepareTail();
+    /// 在 render 开始时读取信箱：先执行待处理的 seek，音量/声像目标变化时
+    /// 开始过渡，有新的节拍写入时应用
+    void pollParams();
+    void seekElapsed(double sec);
+    /// 把播放时钟写入 shownPeriod_/shownFrame_，供其他线程显示
+    void publishClock();
+    void applyBeats(const BeatOverride& beats);
+    /// 节拍过渡结束：在 beatRampEnd_ 处重新锚定为常量目标频率
+    void finishBeatRamp();
+
+    template <typename Sample>
+    void renderInterleaved(Sample* out, size_t frames);
+    float fadeGain(const Period& period, int64_t frame) const;
+    void renderVoices(int64_t blockFrame, int numFrames, float fade);
+    /// 交叉淡化：上一 period 的 voice 渲染到 tailL_/tailR_，与暂存区中
+    /// [offset, offset + numFrames) 的部分按等功率曲线混合
+    void mixTail(int64_t blockFrame, int voiceFrames, int offset,
+                 int numFrames);
+    /// 从相对锚点第 d0 帧起渲染 bank 的 numFrames 帧到 wsL/wsR（累加），
+    /// 扫频按二次相位逐样本求值
+    void oscillate(const VoiceBank& bank, double d0, int numFrames,
+                   float gain, float* wsL, float* wsR);
+    template <typename BinauralOp, typename IsochronicOp>
+    void renderGroups(const VoiceBank& bank, double d0, int numFrames,
+                      float gain, float* wsL, float* wsR,
+                      BinauralOp&& binaural, IsochronicOp&& isochronic);
+    /// 粉红噪声滤波状态定位到块首 blockStart（距 program 起点的帧数）
+    void preparePink(int64_t blockStart);
+    /// 音量与声像，过渡期间在 from 与 to 之间线性插值
+    struct MixParams {
+        float volume;
+        float balance;
+        bool operator!=(const MixParams& o) const {
+            return volume != o.volume || balance != o.balance;
+        }
+    };
+    /// 当前渲染位置之后第 frames 帧的参数
+    MixParams paramsAt(int64_t frames) const;
+    /// hasVoices：暂存区中有发声 voice（含交叉淡化中的上一 period）
+    template <typename Sample>
+    void mixBlock(const Period& period, int64_t blockStart, int offset,
+                  int numFrames, float fade, bool hasVoices, Sample* out);
+    template <typename Sample>
+    void mixBlockGeneric(const Period& period, int64_t blockStart, int offset,
+                         int numFrames, float fade, Sample* out);
 
     SynthesizerConfig config_;
+    const kernels::KernelSet* kernels_;
+    SinTable sinTable_;
     Program program_;
 
-    std::vector<float> freqs_;
-    std::vector<float> vols_;
-    std::vector<float> pitchs_;
-    std::vector<bool> isochronic_;
-    std::vector<float> phasesL_;
-    std::vector<float> phasesR_;
-    std::vector<float> phasesIso_;
+    VoiceBank voices_;
+    int voicesPeriodIndex_ = -1;  // voices_ 对应的 period，-1 表示待重建
+    int64_t anchorFrame_ = 0;     // voices_ 锚点的 period 内帧位置
+    bool scheduled_ = true;       // 节拍按日程变化，未被 setFreqs 覆盖
+    std::vector<PeriodEntry> timeline_;
+    std::vector<double> entryPhaseA_;
+    std::vector<double> entryPhaseB_;
+    LoopPhases loopPhases_;
+    int64_t programFrames_ = 0;  // 规范时间线一轮的帧数
+    uint64_t loop_ = 0;          // 渲染位置所在的轮次，从 0 计
+    // voices_ 的相位仍在规范时间线上（未被 setFreqs 等覆盖偏离）。此时进入
+    // period 取规范进入相位，与 seek 同一运算；偏离后直到下次 seek 都连续带入
+    bool onTimeline_ = true;
+    VoiceBank::FloatArray scratchL_;
+    VoiceBank::FloatArray scratchR_;
+    VoiceBank::FloatArray scratchNoise_;
+    // 暂存区内容所属的块（距 program 起点的块首帧），-1 表示无效：
+    // scratchL_/R_ 为该块前 voicesFrames_ 帧的 voice 混音（锚点变化时失效），
+    // scratchNoise_ 为该块整块的粉红噪声
+    int64_t voicesBlock_ = -1;
+    int voicesFrames_ = 0;
+    int64_t noiseBlock_ = -1;
+    // 交叉淡化：上一 period 的 voice，锚点在其起点；tailPeriod_ 为 -1 时
+    // 没有淡出中的 period。淡化区间为当前 period 的 [0, tailFrames_)
+    int64_t crossfadeFrames_;
+    VoiceBank tailVoices_;
+    int tailPeriod_ = -1;
+    int64_t tailFrames_ = 0;
+    VoiceBank::FloatArray tailL_;
+    VoiceBank::FloatArray tailR_;
+    // 噪声随机数流以距 program 起点的帧数为计数器。粉红噪声滤波状态
+    // 对应 pinkFrame_ 处；pinkBlock_ 为最近一块块首的状态，供块内再次渲染
     PinkNoise pinkNoise_;
-    unsigned int whiteNoiseSeed_ = 1u;
+    PinkNoise pinkBlock_;
+    int64_t pinkFrame_ = -1;
+    int64_t pinkBlockFrame_ = -1;
+    WhiteNoise whiteNoise_;
+
+    int currentPeriodIndex_ = 0;  // 渲染位置所在的 period
+    int64_t renderFrame_ = 0;     // 下一个渲染样本的 period 内帧位置
+    int clockPeriod_ = 0;         // 播放时钟，advanceFrames 推进
+    uint64_t clockLoop_ = 0;      // 播放时钟所在的轮次
+    int64_t periodFrame_ = 0;
+    // 播放时钟的发布副本，音频线程每 buffer 写一次，其他线程只读
+    std::atomic<int> shownPeriod_{0};
+    std::atomic<int64_t> shownFrame_{0};
+    // 控制线程写入的目标值；以下平滑状态只在音频线程上读写
+    ParameterMailbox mailbox_;
+    MixParams paramFrom_{1.0f, 0.f};
+    MixParams paramTo_{1.0f, 0.f};
+    int64_t paramRampFrames_;    // PARAM_RAMP_MS 对应的帧数
+    int64_t paramRampLeft_ = 0;  // 过渡剩余帧数，0 表示已到位
+    bool paramsLive_ = false;    // false 时下次 render 直接取目标值
+    // 节拍过渡的目标与结束位置（period 内帧），-1 表示没有进行中的过渡
+    BeatOverride beatTarget_;
+    int64_t beatRampEnd_ = -1;
+};
 
-    int currentPeriodIndex_ = 0;
-    float periodElapsedSec_ = 0.f;
-    float volumeMultiplier_ = 1.0f;
-    float balance_ = 0.f;  // -1..1
+struct Synthesizer::PreparedProgram {
+    Program program;
+    /// 同一 program 的参数编辑（GUI 滑块等）：period 数与当前 period 的
+    /// voice 数都不变时，adoptProgram 保持播放位置与音量/声像过渡，各 voice
+    /// 相位从正在发声的值接续（按新日程改变频率），不回到起点也不爆音；
+    /// 布局变化时仍从起点播放。setFreqs 覆盖随切换取消
+    bool continuous = false;
+    std::vector<PeriodEntry> timeline;
+    std::vector<double> entryPhaseA;
+    std::vector<double> entryPhaseB;
+    LoopPhases loopPhases;
+    int64_t programFrames = 0;
+    /// 已按 program 最大 voice 数预留
+    VoiceBank voices;
+    VoiceBank tailVoices;
 };
 
 }  // namespace binaural
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace binaural {
+namespace trace {
+
+/// 时间线追踪：作用域事件写入每线程一个的无锁环形缓冲，按需导出为
+/// Chrome trace-event JSON（chrome://tracing、ui.perfetto.dev 可直接打开）。
+/// 只有以 -DBINAURAL_TRACE=ON 配置的构建才记录；否则宏展开为空、
+/// 缓冲区不占空间，dump 返回 false
+#if defined(BINAURAL_TRACE)
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+/// 同时记录的线程数。缓冲在 releaseThread 时归还（线程退出不自动归还），
+/// 超出时新线程暂不记录
+constexpr size_t MAX_THREADS = 16;
+/// 每线程保留的最近事件数，更早的被覆盖
+constexpr size_t EVENTS_PER_THREAD = 16384;
+
+/// 单调时钟，纳秒
+uint64_t nowNs();
+
+/// 为当前线程命名（导出为 thread_name 元数据）。name 须为静态存储的字符串
+void setThreadName(const char* name);
+
+/// 当前线程借用的缓冲所属的线程号，尚未记录过时为 0。实时安全
+uint32_t threadId();
+/// 归还线程号为 tid 的缓冲，可在任意线程调用（如音频流停止后由控制线程
+/// 归还回调线程的缓冲）；调用方须保证该线程此时不在记录。已记录的事件
+/// 保留到被下一个借用者覆盖，该线程之后再记录时重新借用
+void releaseThread(uint32_t tid);
+/// 归还当前线程的缓冲。记录过事件的线程退出前调用
+void releaseThread();
+
+/// 记录一个 [beginNs, endNs) 的完整事件。实时安全：不加锁、不分配。
+/// name 须为静态存储的字符串，且不含引号与反斜杠（原样写入 JSON）
+void record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+/// 把各线程缓冲中现存的事件写成 Chrome trace JSON（非实时，可与记录并发，
+/// 导出期间被覆盖的事件丢弃）。未启用追踪或文件无法写入时返回 false
+bool dump(const std::string& path);
+
+/// 作用域事件：构造时记起点，析构时记录
+class Scope {
+public:
+    explicit Scope(const char* name) : name_(name), begin_(nowNs()) {}
+    ~Scope() { record(name_, begin_, nowNs()); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t begin_;
+};
+
+}  // namespace trace
+}  // namespace binaural
+
+#if defined(BINAURAL_TRACE)
+#define BINAURAL_TRACE_CONCAT_(a, b) a##b
+#define BINAURAL_TRACE_CONCAT(a, b) BINAURAL_TRACE_CONCAT_(a, b)
+/// 记录所在作用域的耗时
+#define BINAURAL_TRACE_SCOPE(name)                                        \
+    ::binaural::trace::Scope BINAURAL_TRACE_CONCAT(traceScope_, __LINE__)( \
+        name)
+/// 为当前线程命名
+#define BINAURAL_TRACE_THREAD(name) ::binaural::trace::setThreadName(name)
+#else
+#define BINAURAL_TRACE_SCOPE(name) ((void)0)
+#define BINAURAL_TRACE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "alignedAllocator.hpp"
+#include "period.hpp"
+#include "phaseModel.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace binaural {
+
+/// 当前 period 的 voice 状态，结构数组（SoA）布局，每列缓存行对齐。
+/// 槽位按类型分组：[0, binauralCount()) 为双耳 voice，其后为等时 voice，
+/// 音量为 0 的 voice（如 Gnaural 的纯粉红噪声条目）排在最后、不参与渲染。
+/// 组内保持 program 中的先后顺序，渲染时每组一个无分支循环。
+/// 外部接口（setBeat 等）按 program 中的 voice 下标访问，内部经 slotOf 映射。
+/// 相位与节拍频率存的是锚点处的值，任意帧的相位由 phase::cycles 闭式求出
+class VoiceBank {
+public:
+    using FloatArray = std::vector<float, AlignedAllocator<float>>;
+    using DoubleArray = std::vector<double, AlignedAllocator<double>>;
+
+    /// 预留 maxVoices 个槽位，之后 rebuild 在该范围内不分配内存
+    void reserve(size_t maxVoices);
+
+    /// 按 period 重新分组并刷新音量、基频、类型，节拍频率重置为 freqStart、
+    /// 斜率为 0。已有 voice 的锚点相位按 voice 下标保留以免爆音，新增 voice 相位为 0。
+    /// pitchOf(j) 返回第 j 个 voice 的基频 (Hz)
+    template <typename PitchFn>
+    void rebuild(const Period& period, PitchFn&& pitchOf);
+
+    size_t size() const { return voiceOfSlot_.size(); }
+    size_t binauralCount() const { return binauralCount_; }
+    size_t isochronicCount() const { return audibleCount_ - binauralCount_; }
+    /// 需要渲染的槽位数，即 [0, audibleCount()) ；其后为静音 voice
+    size_t audibleCount() const { return audibleCount_; }
+
+    /// 按 voice 下标设置常量节拍频率（斜率清零），越界忽略
+    void setBeat(size_t voice, float hz) {
+        if (voice >= slotOfVoice_.size()) return;
+        beat[slotOfVoice_[voice]] = hz;
+        beatSlope[slotOfVoice_[voice]] = 0.0;
+    }
+    void setAllBeats(float hz);
+    /// 节拍频率从锚点处的值在 frames 帧内线性变到 hz（只设斜率），越界忽略
+    void glideBeat(size_t voice, float hz, float frames) {
+        if (voice >= slotOfVoice_.size()) return;
+        const size_t s = slotOfVoice_[voice];
+        beatSlope[s] = (hz - beat[s]) / frames;
+    }
+    void glideAllBeats(float hz, float frames);
+    /// 槽位 s 两个振荡器的频率 (Hz) 与变化率 (Hz/帧)。
+    /// 双耳：A = pitch + beat，B = pitch；等时：A = pitch 载波，B = beat 包络
+    struct Oscillators {
+        double hzA, slopeA;
+        double hzB, slopeB;
+        double slope;  ///< 节拍频率变化率
+    };
+    Oscillators oscillators(size_t s) const {
+        const double p = pitch[s];
+        const double b = beat[s];
+        const double k = beatSlope[s];
+        if (s >= binauralCount_ && s < audibleCount_) return {p, 0.0, b, k, k};
+        return {p + b, k, p, 0.0, k};
+    }
+
+    /// 锚点后移 frames 帧：相位按闭式解推进，节拍频率沿斜率更新。
+    /// 静音 voice 按双耳 voice 推进
+    void reanchor(double frames, double sampleRate);
+
+    size_t slotOf(size_t voice) const { return slotOfVoice_[voice]; }
+    size_t voiceOf(size_t slot) const { return voiceOfSlot_[slot]; }
+
+    // 以下各列按槽位索引
+    FloatArray pitch;   ///< 基频 (Hz)
+    /// 锚点处的节拍频率 (Hz) 与变化率 (Hz/帧)。用 double：长时间扫频中
+    /// 重新锚定时 float 舍入会变成持续的频率偏差
+    DoubleArray beat;
+    DoubleArray beatSlope;
+    FloatArray volume;     ///< program 中的 voice 音量
+    /// 锚点相位（周期）。双耳：phaseA 左、phaseB 右；等时：phaseA 载波、phaseB 包络
+    DoubleArray phaseA;
+    DoubleArray phaseB;
+
+private:
+    void beginRebuild(size_t n);
+    void placeVoice(size_t voice, size_t slot, const BinauralBeatVoice& v,
+                    float pitchHz);
+
+    std::vector<uint32_t> slotOfVoice_;
+    std::vector<uint32_t> voiceOfSlot_;
+    size_t binauralCount_ = 0;
+    size_t audibleCount_ = 0;
+    // rebuild 时暂存上一布局的按 voice 下标状态
+    DoubleArray prevPhaseA_;
+    DoubleArray prevPhaseB_;
+    size_t prevCount_ = 0;
+};
+
+template <typename PitchFn>
+void VoiceBank::rebuild(const Period& period, PitchFn&& pitchOf) {
+    const size_t n = period.voices.size();
+    beginRebuild(n);
+    size_t slot = 0;
+    // 0: 双耳，1: 等时，2: 静音
+    for (int group = 0; group < 3; ++group) {
+        for (size_t j = 0; j < n; ++j) {
+            const BinauralBeatVoice& v = period.voices[j];
+            const int g = v.volume <= 0.f ? 2 : (v.isochronic ? 1 : 0);
+            if (g == group)
+                placeVoice(j, slot++, v, pitchOf(static_cast<int>(j)));
+        }
+        if (group == 0) binauralCount_ = slot;
+        if (group == 1) audibleCount_ = slot;
+    }
+}
+
+}  // namespace binaural
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "audioDriver.hpp"
+#include "writePipeline.hpp"
 #include <atomic>
 #include <string>
 
@@ -13,7 +14,10 @@ public:
     void stop() override;
     bool isRunning() const override;
 
-    void writeToFile(const std::string& path, float durationSec);
+    /// 逐 buffer 调用回调渲染，经 WritePipeline 由写线程流式写入 WAV。
+    /// 失败返回 false；stats 非空时写入吞吐统计
+    bool writeToFile(const std::string& path, float durationSec,
+                     ExportStats* stats = nullptr);
 
 private:
     int sampleRate_ = 44100;
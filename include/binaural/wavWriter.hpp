@@ -0,0 +1,73 @@
+#pragma once
+
+#include "alignedAllocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace binaural {
+
+/// 16-bit PCM WAV 头部长度，含为 RF64 预留的 JUNK/ds64 块
+constexpr size_t WAV_HEADER_SIZE = 80;
+
+/// 按 frames 帧写出完整头部（WAV_HEADER_SIZE 字节）到 out，
+/// 数据超过 4 GiB 时为 RF64
+void makeWavHeader(char* out, int sampleRate, int channels, uint64_t frames);
+/// frames 帧数据是否需要 RF64
+bool isRf64Size(int channels, uint64_t frames);
+
+/// 流式写 16-bit PCM WAV：样本随渲染分块写出，内存占用与时长无关，
+/// close() 时回填头部长度。头部预留 JUNK 块，数据超过 4 GiB 时按
+/// EBU Tech 3306 改写为 RF64（JUNK 换成 ds64，32 位长度字段置 0xFFFFFFFF）
+class WavWriter {
+public:
+    WavWriter() = default;
+    /// 未 close 时自动 close
+    ~WavWriter();
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    /// directIo：Linux 上以 O_DIRECT 绕过页缓存，数据经页对齐暂存区按
+    /// DIRECT_CHUNK 整块写出；文件系统不支持时退回普通写入（见 isDirectIo）
+    bool open(const std::string& path, int sampleRate, int channels = 2,
+              bool directIo = false);
+    /// 追加 frames 帧交错样本
+    bool write(const int16_t* samples, size_t frames);
+    /// 回填头部并关闭文件；任一步写失败返回 false
+    bool close();
+
+    bool isOpen() const;
+    /// 最近一次 open 是否启用了 O_DIRECT（close 后仍有效）
+    bool isDirectIo() const { return directIo_; }
+    uint64_t framesWritten() const { return framesWritten_; }
+    /// 按当前数据量 close 后是否为 RF64
+    bool isRf64() const;
+
+    static constexpr size_t DIRECT_CHUNK = 1 << 20;
+
+private:
+    bool writeBytes(const char* data, size_t n);
+    bool flushDirect(size_t n);
+    bool patchBytes(uint64_t offset, const char* data, size_t n);
+
+    std::string path_;
+    std::ofstream file_;
+    int sampleRate_ = 44100;
+    int channels_ = 2;
+    uint64_t framesWritten_ = 0;
+    bool failed_ = false;
+    // O_DIRECT 路径
+    int fd_ = -1;
+    bool directIo_ = false;
+    std::vector<char, AlignedAllocator<char, 4096>> staging_;
+    size_t staged_ = 0;
+    uint64_t directOffset_ = 0;
+};
+
+/// 一次写完整个文件，samples 为 frames 帧交错立体声样本。失败返回 false
+bool writeWavFile(const std::string& path, int sampleRate,
+                  const int16_t* samples, size_t frames);
+
+}  // namespace binaural
@@ -1,25 +1,45 @@
 #pragma once
 
 #include <atomic>
-#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace binaural {
 
-/// 环形缓冲，供音频回调写入、UI 线程读取用于波形显示
+/// 环形缓冲，供音频回调写入、UI 线程读取用于波形显示。
+/// 单写者、单读者：写入无锁、无等待、不分配；读者复制后校验写位置
+/// （seqlock 式），复制期间被覆写时重试，得到的快照是连续的一段
 class WaveformBuffer {
 public:
+    /// 读者放弃重试前的尝试次数
+    static constexpr int MAX_READ_ATTEMPTS = 4;
+
     explicit WaveformBuffer(size_t capacity = 4096);
 
-    void push(float sampleL, float sampleR);
-    void getSamples(std::vector<float>& outL, std::vector<float>& outR) const;
+    void push(float sampleL, float sampleR) { pushBlock(&sampleL, &sampleR, 1); }
+    /// 追加 n 帧（写线程，实时安全）；n 超过容量时只保留最后 capacity 帧
+    void pushBlock(const float* l, const float* r, size_t n);
+
+    /// 复制最近 capacity 帧（旧在前），尚未写满的部分为 0。
+    /// out 容量足够时不分配。返回 false 表示重试用尽仍被写者追上，
+    /// 此时被覆写的最旧部分置 0
+    bool getSamples(std::vector<float>& outL, std::vector<float>& outR) const;
+
+    size_t capacity() const { return capacity_; }
+    /// 累计写入的帧数
+    uint64_t written() const {
+        return committed_.load(std::memory_order_acquire);
+    }
 
 private:
-    mutable std::mutex mutex_;
-    std::vector<float> bufL_;
-    std::vector<float> bufR_;
-    size_t writeIdx_ = 0;
     size_t capacity_;
+    std::unique_ptr<std::atomic<float>[]> bufL_;
+    std::unique_ptr<std::atomic<float>[]> bufR_;
+    // 写者先推进 claimed_ 再覆写、最后推进 committed_
+    std::atomic<uint64_t> claimed_{0};
+    std::atomic<uint64_t> committed_{0};
 };
 
 }  // namespace binaural
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace binaural {
+
+/// 一列的峰值包络
+struct PeakColumn {
+    float minL = 0.f;
+    float maxL = 0.f;
+    float minR = 0.f;
+    float maxR = 0.f;
+};
+
+/// readEnvelope 实际使用的层级与时间轴
+struct PeakWindow {
+    int level = 0;
+    uint64_t binFrames = 0;  ///< 该层每个 bin 的帧数
+    uint64_t endFrame = 0;   ///< 包络末端（不含）的累计帧号，即该层已完成的 bin 边界
+};
+
+/// 多分辨率 min/max 峰值金字塔，供 GUI 以任意缩放绘制波形包络。
+/// 第 k 层每个 bin 汇总 baseBinFrames * FACTOR^k 帧，各层都是 binsPerLevel
+/// 个 bin 的环形缓冲：内存与历史长度无关，最粗一层覆盖数十分钟。
+/// 音频线程逐帧增量更新（单写者，无锁、不分配）；读者按窗口选层，
+/// 每列只汇总几个 bin，读取量只与列数有关。并发校验方式同 WaveformBuffer
+class WaveformPyramid {
+public:
+    static constexpr uint64_t FACTOR = 4;
+    static constexpr int MAX_READ_ATTEMPTS = 4;
+
+    /// 默认 6 层、每层 4096 bin、最细 16 帧：44.1 kHz 下约 25 分钟历史
+    explicit WaveformPyramid(size_t binsPerLevel = 4096, int levels = 6,
+                             uint64_t baseBinFrames = 16);
+
+    /// 追加 n 帧（写线程，实时安全）
+    void pushBlock(const float* l, const float* r, size_t n);
+    /// 追加交错的 int16 立体声帧（写线程，实时安全）
+    void pushInterleaved(const int16_t* samples, size_t frames);
+
+    /// 最近 windowFrames 帧等分为 columns 列（旧在前）写入 out。
+    /// 每列覆盖的帧范围向外扩展到整 bin，包络不会漏掉峰值；没有历史的列为 0。
+    /// 不分配。返回 false 表示重试用尽仍被写者追上（结果可能混有新旧数据）
+    bool readEnvelope(uint64_t windowFrames, PeakColumn* out, size_t columns,
+                      PeakWindow* window = nullptr) const;
+
+    /// readEnvelope 对该窗口与列数选用的层
+    int levelFor(uint64_t windowFrames, size_t columns) const;
+
+    int levels() const { return static_cast<int>(binFrames_.size()); }
+    size_t binsPerLevel() const { return bins_; }
+    uint64_t binFrames(int level) const { return binFrames_[level]; }
+    /// 最粗一层可回看的帧数
+    uint64_t historyFrames() const { return binFrames_.back() * bins_; }
+    /// 累计写入的帧数
+    uint64_t written() const {
+        return committed_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Accumulator {
+        float minL, maxL, minR, maxR;
+        uint64_t count;
+        void reset();
+    };
+
+    void pushFrame(float l, float r);
+    /// 第 level 层的累加器满一个 bin：写入环形缓冲并汇入上一层
+    void emit(int level);
+    std::atomic<float>* bin(int level, uint64_t index) const {
+        return &peaks_[(static_cast<size_t>(level) * bins_ +
+                        static_cast<size_t>(index % bins_)) *
+                       4];
+    }
+
+    size_t bins_;
+    std::vector<uint64_t> binFrames_;
+    std::unique_ptr<std::atomic<float>[]> peaks_;  // 每 bin 4 个：minL maxL minR maxR
+    // 写者私有
+    std::vector<Accumulator> acc_;
+    std::vector<uint64_t> emitted_;
+    // 写者先推进 claimed_ 再覆写、最后推进 committed_
+    std::atomic<uint64_t> claimed_{0};
+    std::atomic<uint64_t> committed_{0};
+};
+
+}  // namespace binaural
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace binaural {
+
+namespace noise {
+
+/// 计数器式随机数：输出只取决于 (key, counter)，各样本互不依赖，
+/// 整块生成时编译器可直接向量化，也可 O(1) 跳到任意位置
+inline uint32_t hash(uint32_t key, uint64_t counter) {
+    uint32_t x = static_cast<uint32_t>(counter) ^ key;
+    x ^= static_cast<uint32_t>(counter >> 32) * 0x9E3779B9u;
+    // lowbias32 (Chris Wellons)
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+/// [0, 1) 均匀分布，24 位精度
+inline float uniform(uint32_t key, uint64_t counter) {
+    return static_cast<float>(hash(key, counter) >> 8) * (1.0f / 16777216.0f);
+}
+
+/// out[i] = uniform(key, counter + i)
+void uniformBlock(uint32_t key, uint64_t counter, float* out, size_t n);
+
+}  // namespace noise
+
+/// 白噪声，[-1, 1) 均匀分布。tick() 与 generate() 产生同一序列
+class WhiteNoise {
+public:
+    explicit WhiteNoise(uint32_t seed = 1u) : key_(seed) {}
+
+    float tick() { return noise::uniform(key_, counter_++) * 2.0f - 1.0f; }
+    void generate(float* out, size_t n);
+
+    /// 已生成的样本数；seek 后从该位置继续，结果与顺序生成一致
+    uint64_t position() const { return counter_; }
+    void seek(uint64_t sample) { counter_ = sample; }
+
+private:
+    uint32_t key_;
+    uint64_t counter_ = 0;
+};
+
+}  // namespace binaural
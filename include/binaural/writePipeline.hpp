@@ -0,0 +1,52 @@
+#pragma once
+
+#include "alignedAllocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace binaural {
+
+/// 导出统计。渲染停顿为等待空闲缓冲（写入跟不上），写入停顿为等待数据
+/// （渲染跟不上）；两者之一接近 0 说明另一方是瓶颈
+struct ExportStats {
+    uint64_t bytes = 0;
+    double totalSec = 0.0;
+    double renderSec = 0.0;
+    double writeSec = 0.0;
+    double renderStallSec = 0.0;
+    double writeStallSec = 0.0;
+
+    double megabytesPerSec() const {
+        return totalSec > 0.0 ? bytes / (1024.0 * 1024.0) / totalSec : 0.0;
+    }
+};
+
+/// 渲染/写入流水线：调用线程依次填充缓冲池中的块，独立写线程按顺序交给
+/// sink，渲染与磁盘 I/O 重叠。缓冲在构造时一次分配并按页对齐，
+/// 内存占用与导出时长无关
+class WritePipeline {
+public:
+    /// 向 out 填充最多 maxFrames 帧交错立体声，返回实际帧数，0 表示结束
+    using Fill = std::function<size_t(int16_t* out, size_t maxFrames)>;
+    /// 在写线程上调用，返回 false 时中止
+    using Sink = std::function<bool(const int16_t* samples, size_t frames)>;
+
+    static constexpr int DEFAULT_BLOCKS = 3;
+
+    explicit WritePipeline(size_t blockFrames, int numBlocks = DEFAULT_BLOCKS);
+
+    /// 运行到 fill 返回 0 或 sink 失败；sink 全部成功时返回 true
+    bool run(const Fill& fill, const Sink& sink);
+    const ExportStats& stats() const { return stats_; }
+
+private:
+    using Block = std::vector<int16_t, AlignedAllocator<int16_t, 4096>>;
+
+    size_t blockFrames_;
+    std::vector<Block> blocks_;
+    ExportStats stats_;
+};
+
+}  // namespace binaural
@@ -3,8 +3,12 @@
 #include "binaural/audioDriver.hpp"
 #include "binaural/parameterController.hpp"
 #include "binaural/period.hpp"
+#include "binaural/programExchange.hpp"
 #include "binaural/synthesizer.hpp"
-#include "binaural/waveformBuffer.hpp"
+#include "binaural/waveformPyramid.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 namespace binaural {
 struct Program;
@@ -14,10 +18,15 @@ namespace gui {
 
 struct AppContext {
   binaural::Program &program;
+  // Owned by the audio callback while playing. The UI reads the clock it
+  // publishes once per buffer, posts seeks through setPeriodElapsedSec and
+  // parameters through the mailbox setters; program edits go through
+  // `programs`.
   binaural::Synthesizer &synth;
+  binaural::ProgramExchange &programs;
   binaural::ParameterController &paramController;
   binaural::ParameterController::PredictionQueue &predQueue;
-  binaural::WaveformBuffer &waveBuf;
+  binaural::WaveformPyramid &wavePeaks;
   const binaural::SynthesizerConfig &config;
   binaural::IAudioDriver *driver;
 
@@ -29,7 +38,9 @@ struct AppContext {
   bool showLoadModal = false;
   bool showHelpCenter = false;
   bool loadedFromGnaural = false;
-  float manualElapsedSec = 0.f;
+  // Counted in frames by the audio callback so long sessions do not drift;
+  // the UI resets and reads it concurrently.
+  std::atomic<uint64_t> manualElapsedFrames{0};
   char loadPathBuf[512] = {};
   bool timedPlaybackEnabled = false;
   float timedPlaybackDurationSec = 600.f;
@@ -38,6 +49,17 @@ struct AppContext {
 
   // DPI scaling (set each frame in mainLoop)
   float uiScale = 1.f;
+
+  // Waveform view length (mouse wheel zooms) and the envelope columns,
+  // reused every frame so drawing does not allocate.
+  double waveWindowSec = 0.2;
+  std::vector<binaural::PeakColumn> waveColumns;
+
+  double manualElapsedSec() const {
+    return static_cast<double>(
+               manualElapsedFrames.load(std::memory_order_relaxed)) /
+           config.sampleRate;
+  }
 };
 
 void renderTitleBar(AppContext &ctx);
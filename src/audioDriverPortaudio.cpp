@@ -1,7 +1,9 @@
 #include "binaural/audioDriver.hpp"
+#include "binaural/realtimeGuard.hpp"
+#include "binaural/trace.hpp"
 #include <portaudio.h>
 #include <atomic>
-#include <mutex>
+#include <chrono>
 #include <stdexcept>
 
 namespace binaural {
@@ -10,24 +12,33 @@ namespace {
 
 struct StreamUserData {
     AudioCallback callback;
-    std::vector<int16_t> buffer;
-    std::mutex mutex;
     std::atomic<bool> running{false};
+    int sampleRate = 44100;
+    AudioStats stats;
+    // 回调线程的追踪缓冲，流停止后由 stop 归还
+    std::atomic<uint32_t> traceThread{0};
 };
 
 int portAudioCallback(const void* /*input*/, void* output, unsigned long frameCount,
                       const PaStreamCallbackTimeInfo* /*timeInfo*/,
-                      PaStreamCallbackFlags /*flags*/, void* userData) {
+                      PaStreamCallbackFlags flags, void* userData) {
     auto* ud = static_cast<StreamUserData*>(userData);
     if (!ud->running) return paComplete;
-
-    ud->buffer.resize(frameCount * 2);
-    ud->callback(ud->buffer);
-
-    auto* out = static_cast<int16_t*>(output);
-    for (size_t i = 0; i < ud->buffer.size(); ++i) {
-        out[i] = ud->buffer[i];
-    }
+    RealtimeScope realtime;
+    BINAURAL_TRACE_THREAD("audio");
+    BINAURAL_TRACE_SCOPE("audio callback");
+    ud->traceThread.store(trace::threadId(), std::memory_order_relaxed);
+
+    const auto begin = std::chrono::steady_clock::now();
+    // 直接渲染到设备缓冲，没有中转 vector
+    ud->callback(static_cast<int16_t*>(output), frameCount);
+
+    const auto renderNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin);
+    ud->stats.record(static_cast<uint64_t>(renderNs.count()),
+                     frameCount * 1'000'000'000ull / ud->sampleRate,
+                     (flags & paOutputUnderflow) != 0,
+                     (flags & paOutputOverflow) != 0);
     return paContinue;
 }
 
@@ -51,7 +62,7 @@ public:
         if (running_) return false;
 
         userData_.callback = std::move(cb);
-        userData_.buffer.resize(bufferFrames * 2);
+        userData_.sampleRate = sampleRate;
         userData_.running = true;
 
         PaStreamParameters outParam{};
@@ -92,10 +103,13 @@ public:
             Pa_CloseStream(stream_);
             stream_ = nullptr;
         }
+        // 回调已停止，在这里归还回调线程的追踪缓冲
+        trace::releaseThread(userData_.traceThread.exchange(0));
         running_ = false;
     }
 
     bool isRunning() const override { return running_; }
+    const AudioStats* stats() const override { return &userData_.stats; }
 
 private:
     PaStream* stream_ = nullptr;
@@ -0,0 +1,79 @@
+#include "binaural/audioStats.hpp"
+#include <algorithm>
+
+namespace binaural {
+
+namespace {
+// 负载指数平均的权重：约 32 个 buffer 的时间常数
+constexpr float LOAD_SMOOTHING = 1.f / 32.f;
+
+// 单写者：读-改-写不需要 CAS
+void add(std::atomic<uint64_t>& counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+}
+}  // namespace
+
+size_t AudioStats::bucketOf(uint64_t renderNs) {
+    uint64_t us = renderNs / 1000;
+    size_t b = 0;
+    while (us > 1 && b + 1 < BUCKETS) {
+        us >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+void AudioStats::record(uint64_t renderNs, uint64_t budgetNs, bool underflow,
+                        bool overflow) {
+    add(callbacks_, 1);
+    if (underflow) add(underflows_, 1);
+    if (overflow) add(overflows_, 1);
+    if (renderNs > budgetNs) add(misses_, 1);
+    budgetNs_.store(budgetNs, std::memory_order_relaxed);
+    lastRenderNs_.store(renderNs, std::memory_order_relaxed);
+    if (renderNs > maxRenderNs_.load(std::memory_order_relaxed))
+        maxRenderNs_.store(renderNs, std::memory_order_relaxed);
+
+    const float load = budgetNs > 0 ? static_cast<float>(renderNs) /
+                                          static_cast<float>(budgetNs)
+                                    : 0.f;
+    const float prev = load_.load(std::memory_order_relaxed);
+    // 第一次回调直接取值，免得平均值从 0 爬升
+    load_.store(callbacks_.load(std::memory_order_relaxed) == 1
+                    ? load
+                    : prev + (load - prev) * LOAD_SMOOTHING,
+                std::memory_order_relaxed);
+    if (load > maxLoad_.load(std::memory_order_relaxed))
+        maxLoad_.store(load, std::memory_order_relaxed);
+    add(histogram_[bucketOf(renderNs)], 1);
+}
+
+AudioStatsSnapshot AudioStats::snapshot() const {
+    AudioStatsSnapshot s;
+    s.callbacks = callbacks_.load(std::memory_order_relaxed);
+    s.underflows = underflows_.load(std::memory_order_relaxed);
+    s.overflows = overflows_.load(std::memory_order_relaxed);
+    s.deadlineMisses = misses_.load(std::memory_order_relaxed);
+    s.budgetUs = budgetNs_.load(std::memory_order_relaxed) * 1e-3;
+    s.lastRenderUs = lastRenderNs_.load(std::memory_order_relaxed) * 1e-3;
+    s.maxRenderUs = maxRenderNs_.load(std::memory_order_relaxed) * 1e-3;
+    s.load = load_.load(std::memory_order_relaxed);
+    s.maxLoad = maxLoad_.load(std::memory_order_relaxed);
+    for (size_t b = 0; b < BUCKETS; ++b)
+        s.histogram[b] = histogram_[b].load(std::memory_order_relaxed);
+    return s;
+}
+
+void AudioStats::reset() {
+    for (std::atomic<uint64_t>* counter :
+         {&callbacks_, &underflows_, &overflows_, &misses_, &budgetNs_,
+          &lastRenderNs_, &maxRenderNs_}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    load_.store(0.f, std::memory_order_relaxed);
+    maxLoad_.store(0.f, std::memory_order_relaxed);
+    for (auto& bucket : histogram_) bucket.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace binaural
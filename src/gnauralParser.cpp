@@ -75,7 +75,7 @@ bool parseTxtFormat(std::istream& in, Program& out) {
 bool parseXmlFormat(const std::string& content, Program& out) {
     std::vector<float> beatFreqs;
     std::vector<float> baseFreqs;
-    std::vector<int> durations;
+    std::vector<double> durations;
     std::vector<float> volL, volR;
     float noiseVol = 0.f;
 
@@ -86,9 +86,8 @@ bool parseXmlFormat(const std::string& content, Program& out) {
 
     auto addEntry = [&](float durSec, float beat, float base, float vl, float vr, int /*state*/) {
         if (durSec > 0.0001f && (beat > 0.001f || base > 1.f)) {
-            int sec = static_cast<int>(durSec + 0.5f);
-            if (sec < 1) sec = 1;
-            durations.push_back(sec);
+            // 保留小数时长，短 entry 按样本数精确播放
+            durations.push_back(durSec);
             beatFreqs.push_back(beat);
             baseFreqs.push_back(base);
             volL.push_back(vl);
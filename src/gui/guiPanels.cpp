@@ -10,9 +10,11 @@
 #include "binaural/eegPredictorInterface.hpp"
 #include "binaural/gnauralParser.hpp"
 #include "binaural/period.hpp"
+#include "binaural/trace.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <vector>
 
@@ -23,6 +25,8 @@ constexpr float PAD_BASE = 20.f;
 constexpr float TITLE_H_BASE = 48.f;
 constexpr float WAVE_H_BASE = 140.f;
 constexpr float DESC_H_BASE = 44.f;
+constexpr double WAVE_WINDOW_MIN_SEC = 0.005;
+constexpr size_t WAVE_MAX_COLUMNS = 4096;
 } // namespace
 
 void renderTitleBar(AppContext &ctx) {
@@ -40,12 +44,24 @@ void renderTitleBar(AppContext &ctx) {
   ImGui::SameLine(ImGui::GetWindowWidth() / 2.f - 60 * s);
   ImGui::SetCursorPosY(ImGui::GetCursorPosY() - 4 * s);
   ImGui::Text("Binaural Beats");
+  if (const binaural::AudioStats *stats =
+          ctx.driver ? ctx.driver->stats() : nullptr) {
+    const binaural::AudioStatsSnapshot snap = stats->snapshot();
+    ImGui::SameLine();
+    ImGui::TextDisabled("DSP %.1f%%  xruns %llu", snap.load * 100.0,
+                        static_cast<unsigned long long>(snap.xruns()));
+    if (ImGui::IsItemHovered())
+      ImGui::SetTooltip("Peak DSP %.1f%%\nRender max %.0f us / budget %.0f "
+                        "us\nLate callbacks %llu",
+                        snap.maxLoad * 100.0, snap.maxRenderUs, snap.budgetUs,
+                        static_cast<unsigned long long>(snap.deadlineMisses));
+  }
   char eBuf[16], tBuf[16];
   static float frozenManualElapsed = 0.f;
   static bool modalWasOpen = false;
   if (ctx.modalOpen) {
     if (!modalWasOpen)
-      frozenManualElapsed = ctx.manualElapsedSec;
+      frozenManualElapsed = static_cast<float>(ctx.manualElapsedSec());
     modalWasOpen = true;
   } else {
     modalWasOpen = false;
@@ -57,10 +73,11 @@ void renderTitleBar(AppContext &ctx) {
       idx = 0;
     snprintf(eBuf, sizeof(eBuf), "%d",
              static_cast<int>(ctx.synth.periodElapsedSec() + 0.5f));
-    snprintf(tBuf, sizeof(tBuf), "%d", ctx.program.seq[idx].lengthSec);
+    snprintf(tBuf, sizeof(tBuf), "%g", ctx.program.seq[idx].lengthSec);
   } else {
     const float elapsedForDisplay =
-        modalOpen ? frozenManualElapsed : ctx.manualElapsedSec;
+        modalOpen ? frozenManualElapsed
+                  : static_cast<float>(ctx.manualElapsedSec());
     snprintf(eBuf, sizeof(eBuf), "%d",
              static_cast<int>(elapsedForDisplay + 0.5f));
     if (ctx.timedPlaybackEnabled) {
@@ -121,7 +138,7 @@ void renderTitleBar(AppContext &ctx) {
         !ctx.paramController.isAiDriven()) {
       if (ImGui::MenuItem("Exit timed playback")) {
         ctx.timedPlaybackEnabled = false;
-        ctx.manualElapsedSec = 0.f;
+        ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
         ImGui::CloseCurrentPopup();
       }
     } else if (ctx.loadedFromGnaural || ctx.paramController.isAiDriven()) {
@@ -135,7 +152,7 @@ void renderTitleBar(AppContext &ctx) {
               !ctx.program.seq[idx].voices.empty()) {
             ctx.program.seq[idx].voices[0].freqStart = ctx.beatFreq;
             ctx.program.seq[idx].voices[0].freqEnd = ctx.beatFreq;
-            ctx.synth.setProgram(ctx.program);
+            ctx.programs.publish(ctx.program, true);
           }
           ctx.paramController.clearAiState();
         }
@@ -152,12 +169,12 @@ void renderTitleBar(AppContext &ctx) {
               .background = binaural::Period::Background::None,
               .backgroundVol = 0.f,
           });
-          ctx.synth.setProgram(ctx.program);
+          ctx.programs.publish(ctx.program);
           ctx.loadedFromGnaural = false;
           ctx.beatFreq = 4.f;
           ctx.baseFreq = 161.f;
         }
-        ctx.manualElapsedSec = 0.f;
+        ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
         ImGui::CloseCurrentPopup();
       }
     } else {
@@ -178,6 +195,13 @@ void renderTitleBar(AppContext &ctx) {
         ctx.predQueue.push(p);
         ImGui::CloseCurrentPopup();
       }
+      // 仅 BINAURAL_TRACE 构建：导出 Chrome trace，写到工作目录
+      if (binaural::trace::ENABLED &&
+          ImGui::MenuItem("Save trace (binaural_trace.json)")) {
+        if (!binaural::trace::dump("binaural_trace.json"))
+          std::fprintf(stderr, "Failed to write binaural_trace.json\n");
+        ImGui::CloseCurrentPopup();
+      }
     }
     ImGui::EndPopup();
   }
@@ -191,19 +215,55 @@ void renderWaveform(AppContext &ctx) {
   const float waveH = WAVE_H_BASE * s;
   ImGui::SetCursorPos(ImVec2(pad, pad + titleH));
   ImGui::BeginChild("Waveform", ImVec2(-1, waveH), ImGuiChildFlags_None);
-  ImGui::BeginChild("WaveArea", ImVec2(-1, -1), ImGuiChildFlags_None);
-  std::vector<float> samplesL, samplesR;
-  ctx.waveBuf.getSamples(samplesL, samplesR);
-  if (!samplesL.empty()) {
-    float h = (waveH - 24 * s) / 2.f;
-    ImGui::PushStyleColor(ImGuiCol_PlotLines, ImVec4(0.95f, 0.5f, 0.2f, 1.f));
-    ImGui::PlotLines("##L", samplesL.data(),
-                     static_cast<int>(samplesL.size()), 0, nullptr, -1.f, 1.f,
-                     ImVec2(-1, h));
-    ImGui::PlotLines("##R", samplesR.data(),
-                     static_cast<int>(samplesR.size()), 0, nullptr, -1.f, 1.f,
-                     ImVec2(-1, h));
-    ImGui::PopStyleColor();
+  ImGui::BeginChild("WaveArea", ImVec2(-1, -1), ImGuiChildFlags_None,
+                    ImGuiWindowFlags_NoScrollbar |
+                        ImGuiWindowFlags_NoScrollWithMouse);
+  if (ctx.wavePeaks.written() > 0) {
+    // Mouse wheel zooms between a few milliseconds and the full history.
+    const double sr = ctx.config.sampleRate;
+    const float wheel = ImGui::GetIO().MouseWheel;
+    if (wheel != 0.f && ImGui::IsWindowHovered()) {
+      ctx.waveWindowSec = std::clamp(
+          ctx.waveWindowSec * std::pow(0.8, static_cast<double>(wheel)),
+          WAVE_WINDOW_MIN_SEC,
+          static_cast<double>(ctx.wavePeaks.historyFrames()) / sr);
+    }
+    const float width = ImGui::GetContentRegionAvail().x;
+    const size_t columns = static_cast<size_t>(
+        std::clamp(width, 1.f, static_cast<float>(WAVE_MAX_COLUMNS)));
+    ctx.waveColumns.resize(WAVE_MAX_COLUMNS);
+    ctx.wavePeaks.readEnvelope(
+        static_cast<uint64_t>(std::llround(ctx.waveWindowSec * sr)),
+        ctx.waveColumns.data(), columns);
+
+    // One vertical min..max line per column, left channel above right.
+    const float h = (waveH - 24 * s) / 2.f;
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float colW = width / static_cast<float>(columns);
+    ImDrawList *draw = ImGui::GetWindowDrawList();
+    const ImU32 color = ImGui::GetColorU32(ImVec4(0.95f, 0.5f, 0.2f, 1.f));
+    auto toY = [h](float top, float v) {
+      return top + h * 0.5f * (1.f - std::clamp(v, -1.f, 1.f));
+    };
+    for (int ch = 0; ch < 2; ++ch) {
+      const float top = origin.y + h * static_cast<float>(ch);
+      for (size_t c = 0; c < columns; ++c) {
+        const binaural::PeakColumn &p = ctx.waveColumns[c];
+        const float x = origin.x + (static_cast<float>(c) + 0.5f) * colW;
+        const float y0 = toY(top, ch == 0 ? p.maxL : p.maxR);
+        const float y1 = toY(top, ch == 0 ? p.minL : p.minR);
+        draw->AddLine(ImVec2(x, y0), ImVec2(x, std::max(y1, y0 + 1.f)), color,
+                      std::max(colW, 1.f));
+      }
+    }
+    char label[32];
+    if (ctx.waveWindowSec < 1.0)
+      std::snprintf(label, sizeof(label), "%.0f ms", ctx.waveWindowSec * 1e3);
+    else
+      std::snprintf(label, sizeof(label), "%.1f s", ctx.waveWindowSec);
+    draw->AddText(ImVec2(origin.x + 4 * s, origin.y),
+                  ImGui::GetColorU32(ImVec4(0.4f, 0.4f, 0.45f, 1.f)), label);
+    ImGui::Dummy(ImVec2(width, 2.f * h));
   } else {
     ImGui::SetCursorPos(ImVec2(ImGui::GetContentRegionAvail().x / 2.f - 40 * s,
                                (waveH - 24 * s) / 2.f - 8 * s));
@@ -246,8 +306,10 @@ void renderControls(AppContext &ctx) {
     ctx.beatFreq = ctx.paramController.currentBeatFreq();
   } else if (ctx.playing && !ctx.program.seq.empty() &&
              curIdx < static_cast<int>(ctx.program.seq.size())) {
-    const binaural::Period *curP = ctx.synth.currentPeriod();
-    if (curP && !curP->voices.empty()) {
+    // The UI's copy matches what was last published; the synth's own program
+    // may be swapped out by the audio thread at any time.
+    const binaural::Period *curP = &ctx.program.seq[curIdx];
+    if (!curP->voices.empty()) {
       const auto &v = curP->voices[0];
       float len = static_cast<float>(curP->lengthSec);
       float pos = ctx.synth.periodElapsedSec();
@@ -273,13 +335,15 @@ void renderControls(AppContext &ctx) {
   if (sliderWithButtons("Binaural Beat", &ctx.beatFreq, BEAT_MIN, BEAT_MAX,
                         "%.3f Hz", 0.5f, buf, "%.3f", "Hz", s)) {
     if (!ctx.loadedFromGnaural)
-      ctx.manualElapsedSec = 0.f;
+      ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
     if (!ctx.program.seq.empty() &&
         curIdx < static_cast<int>(ctx.program.seq.size()) &&
         !ctx.program.seq[curIdx].voices.empty()) {
       ctx.program.seq[curIdx].voices[0].freqStart = ctx.beatFreq;
       ctx.program.seq[curIdx].voices[0].freqEnd = ctx.beatFreq;
-      ctx.synth.setProgram(ctx.program);
+      // Parameter edits publish continuously: playback keeps its position
+      // and the running oscillator phases, so dragging a slider never clicks.
+      ctx.programs.publish(ctx.program, true);
     }
   }
   if (ctx.paramController.isAiDriven()) {
@@ -321,12 +385,12 @@ void renderControls(AppContext &ctx) {
   if (sliderWithButtons("Base Frequency", &ctx.baseFreq, BASE_FREQ_MIN,
                         BASE_FREQ_MAX, "%.3f Hz", 5.f, buf, "%.3f", "Hz", s)) {
     if (!ctx.loadedFromGnaural)
-      ctx.manualElapsedSec = 0.f;
+      ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
     if (!ctx.program.seq.empty() &&
         curIdx < static_cast<int>(ctx.program.seq.size()) &&
         !ctx.program.seq[curIdx].voices.empty()) {
       ctx.program.seq[curIdx].voices[0].pitch = ctx.baseFreq;
-      ctx.synth.setProgram(ctx.program);
+      ctx.programs.publish(ctx.program, true);
     }
   }
   ImGui::Spacing();
@@ -335,7 +399,7 @@ void renderControls(AppContext &ctx) {
                         "%.3f", 0.1f, getBalanceLabel(ctx.balance), "%.3f",
                         "", s)) {
     if (!ctx.loadedFromGnaural)
-      ctx.manualElapsedSec = 0.f;
+      ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
     ctx.synth.setBalance(ctx.balance);
   }
   ImGui::Spacing();
@@ -346,19 +410,19 @@ void renderControls(AppContext &ctx) {
     bool iso = ctx.program.seq[curIdx].voices[0].isochronic;
     if (ImGui::Checkbox("Isochronic", &iso)) {
       if (!ctx.loadedFromGnaural)
-        ctx.manualElapsedSec = 0.f;
+        ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
       ctx.program.seq[curIdx].voices[0].isochronic = iso;
-      ctx.synth.setProgram(ctx.program);
+      ctx.programs.publish(ctx.program, true);
     }
     ImGui::SameLine(120 * s);
     int bg = static_cast<int>(ctx.program.seq[curIdx].background);
     const char *bgNames[] = {"No noise", "Pink noise", "White noise"};
     if (ImGui::Combo("Background", &bg, bgNames, 3)) {
       if (!ctx.loadedFromGnaural)
-        ctx.manualElapsedSec = 0.f;
+        ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
       ctx.program.seq[curIdx].background =
           static_cast<binaural::Period::Background>(bg);
-      ctx.synth.setProgram(ctx.program);
+      ctx.programs.publish(ctx.program, true);
     }
     if (ctx.program.seq[curIdx].background !=
         binaural::Period::Background::None) {
@@ -375,8 +439,8 @@ void renderControls(AppContext &ctx) {
                              &ctx.program.seq[curIdx].backgroundVol, 0.f, 1.f,
                              "%.2f")) {
         if (!ctx.loadedFromGnaural)
-          ctx.manualElapsedSec = 0.f;
-        ctx.synth.setProgram(ctx.program);
+          ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
+        ctx.programs.publish(ctx.program, true);
       }
       ImGui::PopID();
     }
@@ -402,19 +466,15 @@ void renderControls(AppContext &ctx) {
     if (ctx.playing) {
       ctx.driver->start(
           ctx.config.sampleRate, ctx.config.bufferFrames,
-          [&ctx](std::vector<int16_t> &buf) {
-            float delta = static_cast<float>(ctx.config.bufferFrames) /
-                          ctx.config.sampleRate;
-            ctx.paramController.update(ctx.synth.periodElapsedSec());
-            ctx.synth.fillSamples(buf);
-            for (size_t i = 0; i < buf.size(); i += 8) {
-              float l = buf[i] / 32768.f;
-              float r = buf[i + 1] / 32768.f;
-              ctx.waveBuf.push(l, r);
-            }
-            ctx.synth.advanceTime(delta);
+          [&ctx](int16_t *samples, size_t frames) {
+            ctx.programs.apply(ctx.synth);
+            ctx.paramController.update();
+            ctx.synth.render(samples, frames);
+            ctx.wavePeaks.pushInterleaved(samples, frames);
+            ctx.synth.advanceFrames(frames);
             if (!ctx.loadedFromGnaural)
-              ctx.manualElapsedSec += delta;
+              ctx.manualElapsedFrames.fetch_add(frames,
+                                                std::memory_order_relaxed);
           });
     } else {
       const bool wasAiDriven = ctx.paramController.isAiDriven();
@@ -426,9 +486,9 @@ void renderControls(AppContext &ctx) {
             !ctx.program.seq[idx].voices.empty()) {
           ctx.program.seq[idx].voices[0].freqStart = ctx.beatFreq;
           ctx.program.seq[idx].voices[0].freqEnd = ctx.beatFreq;
-          ctx.synth.setProgram(ctx.program);
+          ctx.programs.publish(ctx.program, true);
         }
-        ctx.manualElapsedSec = 0.f;
+        ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
       }
       ctx.paramController.clearAiState();
       ctx.driver->stop();
@@ -532,7 +592,7 @@ void renderLoadModal(AppContext &ctx) {
     if (ImGui::Button("Load")) {
       if (auto prog = binaural::parseGnaural(ctx.loadPathBuf)) {
         ctx.program = std::move(*prog);
-        ctx.synth.setProgram(ctx.program);
+        ctx.programs.publish(ctx.program);
         ctx.loadedFromGnaural = true;
         if (!ctx.program.seq.empty() &&
             !ctx.program.seq[0].voices.empty()) {
@@ -572,7 +632,7 @@ void renderTimedPlaybackModal(AppContext &ctx) {
     ImGui::Spacing();
     if (ImGui::Button("OK", ImVec2(80, 0))) {
       ctx.timedPlaybackEnabled = true;
-      ctx.manualElapsedSec = 0.f;
+      ctx.manualElapsedFrames.store(0, std::memory_order_relaxed);
       ImGui::CloseCurrentPopup();
     }
     ImGui::SameLine();
@@ -3,6 +3,7 @@
 #include "gui/guiUtils.hpp"
 #include "binaural/parameterController.hpp"
 #include "binaural/audioDriver.hpp"
+#include "binaural/trace.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -14,6 +15,8 @@ namespace gui {
 void doOneRenderFrame(RenderFrameData &data) {
   if (!data.ctx || !data.window)
     return;
+  BINAURAL_TRACE_THREAD("gui");
+  BINAURAL_TRACE_SCOPE("gui frame");
   AppContext &ctx = *data.ctx;
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplGlfw_NewFrame();
@@ -76,7 +79,7 @@ void doOneRenderFrame(RenderFrameData &data) {
 
   if (data.paramController && data.driver &&
       ctx.playing && !ctx.loadedFromGnaural && ctx.timedPlaybackEnabled &&
-      ctx.manualElapsedSec >= ctx.timedPlaybackDurationSec) {
+      ctx.manualElapsedSec() >= ctx.timedPlaybackDurationSec) {
     data.paramController->clearAiState();
     data.driver->stop();
     ctx.playing = false;
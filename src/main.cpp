@@ -1,12 +1,20 @@
 #include "binaural/audioDriver.hpp"
 #include "binaural/gnauralParser.hpp"
+#include "binaural/mappedWavFile.hpp"
+#include "binaural/offlineRenderer.hpp"
 #include "binaural/period.hpp"
+#include "binaural/renderCache.hpp"
 #include "binaural/synthesizer.hpp"
+#include "binaural/trace.hpp"
 #include "binaural/wavDriver.hpp"
+#include "binaural/wavWriter.hpp"
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
 #ifdef _WIN32
@@ -33,6 +41,22 @@ static void printUsage(const char *prog) {
       << "  --isochronic       Use isochronic tones instead of binaural\n"
       << "  --volume F         Master volume 0-1.2 (default: 0.7)\n"
       << "  --file PATH        Load .gnaural or .txt schedule file\n"
+      << "  --crossfade MS     Crossfade between periods in ms (default: 0, "
+         "hard switch)\n"
+      << "  --quality TIER     Sine quality: draft, standard, reference "
+         "(default: reference)\n"
+      << "  --export PATH      Render the whole program to a WAV file and exit\n"
+      << "  --threads N        Render threads for --export (default: all "
+         "cores)\n"
+      << "  --direct-io        Write --export output with O_DIRECT (Linux)\n"
+      << "  --mmap             Render --export straight into a memory-mapped "
+         "file\n"
+      << "  --cache DIR        Reuse rendered periods cached in DIR for "
+         "--export\n"
+      << "  --cache-size MB    Cache size limit before LRU eviction (default: "
+         "2048)\n"
+      << "  --trace PATH       Write a Chrome trace JSON on exit (builds "
+         "configured with -DBINAURAL_TRACE=ON)\n"
       << "  --help             Print this help\n";
 }
 
@@ -63,6 +87,15 @@ int main(int argc, char *argv[]) {
   bool isochronic = false;
   float volume = 0.7f;
   std::string gnauralPath;
+  QualityTier quality = QualityTier::Reference;
+  std::string exportPath;
+  int threads = 0;
+  int crossfadeMs = 0;
+  bool directIo = false;
+  bool mappedExport = false;
+  std::string cacheDir;
+  std::string tracePath;
+  int cacheSizeMb = static_cast<int>(RenderCache::DEFAULT_MAX_BYTES >> 20);
 
   for (int i = 1; i < argc; ++i) {
     const char *arg = argv[i];
@@ -158,6 +191,94 @@ int main(int argc, char *argv[]) {
       gnauralPath = argv[++i];
       continue;
     }
+    if (std::strcmp(arg, "--crossfade") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: --crossfade requires a value\n";
+        return 1;
+      }
+      if (!parseInt(argv[++i], crossfadeMs) || crossfadeMs < 0) {
+        std::cerr << "Error: crossfade must be a non-negative number of ms\n";
+        return 1;
+      }
+      continue;
+    }
+    if (std::strcmp(arg, "--quality") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: --quality requires draft|standard|reference\n";
+        return 1;
+      }
+      std::string t(argv[++i]);
+      if (t == "draft")
+        quality = QualityTier::Draft;
+      else if (t == "standard")
+        quality = QualityTier::Standard;
+      else if (t == "reference")
+        quality = QualityTier::Reference;
+      else {
+        std::cerr << "Error: quality must be draft, standard or reference\n";
+        return 1;
+      }
+      continue;
+    }
+    if (std::strcmp(arg, "--export") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: --export requires a path\n";
+        return 1;
+      }
+      exportPath = argv[++i];
+      continue;
+    }
+    if (std::strcmp(arg, "--direct-io") == 0) {
+      directIo = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--mmap") == 0) {
+      mappedExport = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--cache") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: --cache requires a directory\n";
+        return 1;
+      }
+      cacheDir = argv[++i];
+      continue;
+    }
+    if (std::strcmp(arg, "--cache-size") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: --cache-size requires a value\n";
+        return 1;
+      }
+      if (!parseInt(argv[++i], cacheSizeMb) || cacheSizeMb <= 0) {
+        std::cerr << "Error: cache size must be a positive number of MB\n";
+        return 1;
+      }
+      continue;
+    }
+    if (std::strcmp(arg, "--threads") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: --threads requires a value\n";
+        return 1;
+      }
+      if (!parseInt(argv[++i], threads) || threads > 256) {
+        std::cerr << "Error: threads must be 0-256\n";
+        return 1;
+      }
+      continue;
+    }
+    if (std::strcmp(arg, "--trace") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: --trace requires a path\n";
+        return 1;
+      }
+      if (!trace::ENABLED) {
+        std::cerr << "Error: --trace needs a build configured with "
+                     "-DBINAURAL_TRACE=ON\n";
+        return 1;
+      }
+      tracePath = argv[++i];
+      continue;
+    }
     std::cerr << "Unknown option: " << arg << "\nUse --help for usage.\n";
     return 1;
   }
@@ -175,7 +296,7 @@ int main(int argc, char *argv[]) {
   } else {
     program.name = "CLI";
     program.seq.push_back({
-        .lengthSec = durationSec,
+        .lengthSec = static_cast<double>(durationSec),
         .voices = {{
             .freqStart = beatFreq,
             .freqEnd = beatFreq,
@@ -193,18 +314,92 @@ int main(int argc, char *argv[]) {
   config.sampleRate = 44100;
   config.bufferFrames = 2048;
   config.iscale = 1440;
+  config.quality = quality;
+  config.crossfadeMs = crossfadeMs;
+
+  // 离线导出：与实时回调相同的逐 buffer 流程，按时间块多线程渲染，
+  // 写线程同时落盘；--mmap 时各线程直接渲染进映射文件中各自的时间片
+  auto exportWav = [&](const std::string &path) {
+    OfflineRenderer renderer(program, config);
+    std::unique_ptr<RenderCache> cache;
+    if (!cacheDir.empty()) {
+      cache = std::make_unique<RenderCache>(
+          cacheDir, static_cast<uint64_t>(cacheSizeMb) << 20);
+      renderer.setCache(cache.get());
+    }
+    WavWriter writer;
+    ExportStats stats;
+    bool ok = false;
+    if (mappedExport) {
+      const auto t0 = std::chrono::steady_clock::now();
+      MappedWavFile file;
+      if (file.create(path, config.sampleRate, renderer.totalFrames())) {
+        renderer.render(file.samples(), threads);
+        ok = file.close();
+      }
+      stats.bytes = renderer.totalFrames() * 2 * sizeof(int16_t);
+      stats.totalSec = stats.renderSec =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+              .count();
+    } else {
+      ok = writer.open(path, config.sampleRate, 2, directIo) &&
+           renderer.render(
+               [&writer](const int16_t *samples, size_t frames) {
+                 return writer.write(samples, frames);
+               },
+               threads, &stats) &&
+           writer.close();
+    }
+    if (!ok) {
+      std::cerr << "Error: failed to write " << path << "\n";
+      return false;
+    }
+    if (directIo && !mappedExport && !writer.isDirectIo())
+      std::cout << "O_DIRECT unavailable, used buffered writes\n";
+    const double audioSec =
+        static_cast<double>(renderer.totalFrames()) / config.sampleRate;
+    const double sec = stats.totalSec;
+    std::cout << "Rendered " << audioSec << " s in " << sec << " s ("
+              << (sec > 0.0 ? audioSec / sec : 0.0) << "x realtime), "
+              << stats.bytes / (1024.0 * 1024.0) << " MB at "
+              << stats.megabytesPerSec() << " MB/s\n"
+              << "  render " << stats.renderSec << " s (stalled "
+              << stats.renderStallSec << " s), write " << stats.writeSec
+              << " s (stalled " << stats.writeStallSec << " s)\n";
+    if (cache) {
+      const RenderCacheStats &cs = cache->stats();
+      std::cout << "Cache: " << cs.hits << " hits, " << cs.misses
+                << " misses, " << cs.bytesRead / (1024.0 * 1024.0)
+                << " MB read, " << cs.bytesWritten / (1024.0 * 1024.0)
+                << " MB written, " << cs.evictions << " evicted\n";
+    }
+    return true;
+  };
+
+  auto saveTrace = [&tracePath]() {
+    if (tracePath.empty())
+      return;
+    if (trace::dump(tracePath))
+      std::cout << "Trace written to " << tracePath << "\n";
+    else
+      std::cerr << "Error: failed to write trace " << tracePath << "\n";
+  };
+
+  if (!exportPath.empty()) {
+    std::cout << "Exporting " << exportPath << "...\n";
+    const bool exported = exportWav(exportPath);
+    saveTrace();
+    return exported ? 0 : 1;
+  }
 
   Synthesizer synth(config);
   synth.setProgram(program);
 
   auto driver = createPortAudioDriver();
   bool ok = driver->start(config.sampleRate, config.bufferFrames,
-                          [&synth, &config](std::vector<int16_t> &buf) {
-                            synth.skewVoices(synth.periodElapsedSec());
-                            synth.fillSamples(buf);
-                            synth.advanceTime(
-                                static_cast<float>(config.bufferFrames) /
-                                config.sampleRate);
+                          [&synth](int16_t *samples, size_t frames) {
+                            synth.render(samples, frames);
+                            synth.advanceFrames(frames);
                           });
 
   if (!ok) {
@@ -212,27 +407,23 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  if (auto *wav = dynamic_cast<WavFileDriver *>(driver.get())) {
-    int totalSec = 0;
+  if (dynamic_cast<WavFileDriver *>(driver.get())) {
+    double totalSec = 0.0;
     for (const auto &p : program.seq)
       totalSec += p.lengthSec;
-    if (totalSec <= 0)
-      totalSec = durationSec;
     std::cout << "PortAudio not found. Writing output.wav (" << totalSec
               << " sec)...\n";
-    wav->writeToFile("output.wav", static_cast<float>(totalSec));
+    if (!exportWav("output.wav"))
+      return 1;
     std::cout << "Done. Play output.wav to verify.\n";
     return 0;
   }
 
   auto startPlayback = [&]() {
     return driver->start(config.sampleRate, config.bufferFrames,
-                         [&synth, &config](std::vector<int16_t> &buf) {
-                           synth.skewVoices(synth.periodElapsedSec());
-                           synth.fillSamples(buf);
-                           synth.advanceTime(
-                               static_cast<float>(config.bufferFrames) /
-                               config.sampleRate);
+                         [&synth](int16_t *samples, size_t frames) {
+                           synth.render(samples, frames);
+                           synth.advanceFrames(frames);
                          });
   };
 
@@ -305,7 +496,7 @@ int main(int argc, char *argv[]) {
       if (idx >= static_cast<int>(program.seq.size()))
         idx = 0;
       elapsed = synth.periodElapsedSec();
-      displayTotal = program.seq[idx].lengthSec;
+      displayTotal = static_cast<int>(std::lround(program.seq[idx].lengthSec));
     } else {
       elapsed = playing ? totalElapsed +
                               std::chrono::duration<float>(
@@ -336,11 +527,21 @@ int main(int argc, char *argv[]) {
                           : (stateCode == 2) ? "[Done]   "
                                              : "[Paused] ";
       std::cout << "\rduration " << displaySec << " / " << displayTotal
-                << " s  " << state << "  " << std::flush;
+                << " s  " << state << "  ";
+      if (const AudioStats *stats = driver->stats()) {
+        const AudioStatsSnapshot snap = stats->snapshot();
+        char dsp[96];
+        std::snprintf(dsp, sizeof(dsp), "DSP %4.1f%% (max %4.1f%%)  xruns %llu  ",
+                      snap.load * 100.0, snap.maxLoad * 100.0,
+                      static_cast<unsigned long long>(snap.xruns()));
+        std::cout << dsp;
+      }
+      std::cout << std::flush;
     }
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
   }
   driver->stop();
   std::cout << "\nQuit.\n";
+  saveTrace();
   return 0;
 }
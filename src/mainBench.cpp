@@ -0,0 +1,2582 @@
+#include "binaural/audioStats.hpp"
+#include "binaural/eegPredictorInterface.hpp"
+#include "binaural/gnauralParser.hpp"
+#include "binaural/lockFreeQueue.hpp"
+#include "binaural/mappedWavFile.hpp"
+#include "binaural/offlineRenderer.hpp"
+#include "binaural/oscillatorKernels.hpp"
+#include "binaural/parameterMailbox.hpp"
+#include "binaural/period.hpp"
+#include "binaural/programExchange.hpp"
+#include "binaural/realtimeGuard.hpp"
+#include "binaural/renderCache.hpp"
+#include "binaural/synthesizer.hpp"
+#include "binaural/trace.hpp"
+#include "binaural/wavWriter.hpp"
+#include "binaural/waveformBuffer.hpp"
+#include "binaural/waveformPyramid.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace binaural;
+
+namespace {
+
+constexpr int BENCH_FRAMES = 2048;
+constexpr int BENCH_VOICES = 64;
+constexpr int BENCH_REPEATS = 50;
+constexpr float SAMPLE_RATE = 44100.f;
+
+// curve 为节拍扫频的相位二次项（双耳作用于 A，等时作用于包络）
+struct VoiceCase {
+  float phaseA, incA, phaseB, incB, curve;
+};
+
+std::vector<VoiceCase> makeCases(int count) {
+  std::mt19937 rng(12345u);
+  std::uniform_real_distribution<float> phase(0.f, 1.f);
+  std::uniform_real_distribution<float> base(20.f, 500.f);
+  std::uniform_real_distribution<float> beat(0.f, 40.f);
+  // 每秒至多 ±40 Hz 的扫频
+  std::uniform_real_distribution<float> sweep(-40.f, 40.f);
+  std::vector<VoiceCase> cases(count);
+  for (auto &c : cases) {
+    c.phaseA = phase(rng);
+    c.phaseB = phase(rng);
+    c.incA = (base(rng) + beat(rng)) / SAMPLE_RATE;
+    c.incB = beat(rng) / SAMPLE_RATE;
+    c.curve = 0.5f * sweep(rng) / (SAMPLE_RATE * SAMPLE_RATE);
+  }
+  return cases;
+}
+
+void renderAll(const kernels::KernelSet &k, bool isochronic,
+               const std::vector<VoiceCase> &cases, std::vector<float> &outL,
+               std::vector<float> &outR) {
+  std::fill(outL.begin(), outL.end(), 0.f);
+  std::fill(outR.begin(), outR.end(), 0.f);
+  for (const auto &c : cases) {
+    if (isochronic)
+      k.isochronic(outL.data(), outR.data(), BENCH_FRAMES,
+                   {c.phaseA, c.incA, 0.f}, {c.phaseB, c.incB, c.curve}, 1.f);
+    else
+      k.binaural(outL.data(), outR.data(), BENCH_FRAMES,
+                 {c.phaseA, c.incA, c.curve}, {c.phaseB, c.incA - c.incB, 0.f},
+                 1.f);
+  }
+}
+
+const kernels::KernelSet LIBM_KERNELS{SimdLevel::Scalar,
+                                      QualityTier::Reference,
+                                      kernels::binauralLibm,
+                                      kernels::isochronicLibm};
+
+// 单 voice 逐一与 std::sin 参考（逐帧累加相位，即原 fillSamples 的算法）
+// 比较，误差按 vol = 1 计
+float maxErrorVsLibm(const kernels::KernelSet &k, bool isochronic,
+                     const std::vector<VoiceCase> &cases) {
+  const auto &ref = LIBM_KERNELS;
+  std::vector<float> aL(BENCH_FRAMES), aR(BENCH_FRAMES);
+  std::vector<float> bL(BENCH_FRAMES), bR(BENCH_FRAMES);
+  float maxErr = 0.f;
+  for (const auto &c : cases) {
+    const std::vector<VoiceCase> one{c};
+    renderAll(ref, isochronic, one, aL, aR);
+    renderAll(k, isochronic, one, bL, bR);
+    for (int i = 0; i < BENCH_FRAMES; ++i) {
+      maxErr = std::max(maxErr, std::abs(aL[i] - bL[i]));
+      maxErr = std::max(maxErr, std::abs(aR[i] - bR[i]));
+    }
+  }
+  return maxErr;
+}
+
+double nsPerVoiceFrame(const kernels::KernelSet &k, bool isochronic,
+                       const std::vector<VoiceCase> &cases) {
+  std::vector<float> outL(BENCH_FRAMES), outR(BENCH_FRAMES);
+  renderAll(k, isochronic, cases, outL, outR);
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < BENCH_REPEATS; ++r)
+    renderAll(k, isochronic, cases, outL, outR);
+  const auto t1 = std::chrono::steady_clock::now();
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  return ns / (static_cast<double>(BENCH_REPEATS) * cases.size() *
+               BENCH_FRAMES);
+}
+
+struct ToneQuality {
+  double thdDb;
+  double snrDb;
+};
+
+// x 中频率为 freq 的正弦分量（最小二乘），N 为整数个周期时无泄漏
+struct ToneFit {
+  double a, b, w;
+  double meanSquare() const { return 0.5 * (a * a + b * b); }
+};
+
+ToneFit fitTone(const std::vector<float> &x, double freq) {
+  double re = 0.0, im = 0.0;
+  const double w = 2.0 * 3.14159265358979323846 * freq / SAMPLE_RATE;
+  for (size_t i = 0; i < x.size(); ++i) {
+    re += x[i] * std::cos(w * i);
+    im += x[i] * std::sin(w * i);
+  }
+  const double n = static_cast<double>(x.size());
+  return {2.0 * re / n, 2.0 * im / n, w};
+}
+
+Program toneProgram(int numVoices, float pitch) {
+  Program p;
+  p.name = "bench";
+  Period period;
+  period.lengthSec = 3600;
+  for (int j = 0; j < numVoices; ++j) {
+    period.voices.push_back({
+        .freqStart = 0.f,
+        .freqEnd = 0.f,
+        .volume = 1.f,
+        .pitch = pitch + 3.f * j,
+        .isochronic = false,
+    });
+  }
+  p.seq.push_back(std::move(period));
+  return p;
+}
+
+// 单音 THD/SNR：687 Hz 取 1 s，恰好 687 个周期，谐波无泄漏。每帧相位步进
+// 687/44100 不是二进制有限小数，float 相位的舍入与实际节目频率一样计入
+// 结果。THD 取 2..10 次谐波；SNR 为 SINAD，残差为输出减去按 double 拟合的
+// 基波正弦（时域相减，避免能量相减的舍入）
+ToneQuality measureTone(OscillatorBackend backend, SimdLevel simd,
+                        QualityTier quality) {
+  constexpr int n = static_cast<int>(SAMPLE_RATE);
+  constexpr double TONE_HZ = 687.0;
+  SynthesizerConfig cfg;
+  cfg.oscillator = backend;
+  cfg.simd = simd;
+  cfg.quality = quality;
+  Synthesizer synth(cfg);
+  synth.setProgram(toneProgram(1, static_cast<float>(TONE_HZ)));
+  // 越过 period 开头 FADE_INOUT_PERIOD 的淡入，否则测到的是增益斜坡
+  synth.seekProgram(static_cast<uint64_t>(10 * SAMPLE_RATE));
+  std::vector<float> stereo(static_cast<size_t>(n) * 2);
+  synth.render(stereo.data(), static_cast<size_t>(n));
+  std::vector<float> left(n);
+  for (int i = 0; i < n; ++i)
+    left[i] = stereo[i * 2];
+
+  const ToneFit fund = fitTone(left, TONE_HZ);
+  double residual = 0.0;
+  for (int i = 0; i < n; ++i) {
+    const double e = left[i] - (fund.a * std::cos(fund.w * i) +
+                                fund.b * std::sin(fund.w * i));
+    residual += e * e;
+  }
+  residual = std::max(residual / n, 1e-30);
+  double harmonics = 0.0;
+  for (int h = 2; h <= 10 && h * TONE_HZ < SAMPLE_RATE / 2; ++h)
+    harmonics += fitTone(left, h * TONE_HZ).meanSquare();
+  return {10.0 * std::log10(std::max(harmonics, 1e-30) / fund.meanSquare()),
+          10.0 * std::log10(fund.meanSquare() / residual)};
+}
+
+double synthNsPerVoiceFrame(OscillatorBackend backend, SimdLevel simd,
+                            QualityTier quality) {
+  SynthesizerConfig cfg;
+  cfg.oscillator = backend;
+  cfg.simd = simd;
+  cfg.quality = quality;
+  Synthesizer synth(cfg);
+  synth.setProgram(toneProgram(BENCH_VOICES, 100.f));
+  std::vector<int16_t> buf;
+  synth.fillSamples(buf);
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < BENCH_REPEATS; ++r)
+    synth.fillSamples(buf);
+  const auto t1 = std::chrono::steady_clock::now();
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  return ns / (static_cast<double>(BENCH_REPEATS) * BENCH_VOICES *
+               cfg.bufferFrames);
+}
+
+// 非二进制频率下 SNR 同时受正弦近似与 float 相位舍入限制，与实际播放一致。
+// 要求：reference 档多项式高于 libm（原 fillSamples 的逐帧 float 相位累加）
+// 且不低于 100 dB；三档多项式依次拉开；查表高于 draft。table 与 fixed 共用
+// 同一张线性插值表，fixed 按 64 位定点累加相位，SNR 不低于 table
+bool benchOscillatorBackends() {
+  struct Row {
+    OscillatorBackend backend;
+    SimdLevel simd;
+    QualityTier quality;
+  };
+  const Row rows[] = {
+      {OscillatorBackend::Libm, SimdLevel::Scalar, QualityTier::Reference},
+      {OscillatorBackend::Polynomial, SimdLevel::Auto, QualityTier::Draft},
+      {OscillatorBackend::Polynomial, SimdLevel::Auto, QualityTier::Standard},
+      {OscillatorBackend::Polynomial, SimdLevel::Auto, QualityTier::Reference},
+      {OscillatorBackend::Table, SimdLevel::Auto, QualityTier::Reference},
+      {OscillatorBackend::FixedPoint, SimdLevel::Auto, QualityTier::Reference},
+  };
+  std::printf("\nOscillator backends (Synthesizer, %d voices; 687 Hz tone "
+              "for THD/SNR)\n",
+              BENCH_VOICES);
+  std::printf("%-8s %-8s %-10s %14s %14s %10s %10s\n", "backend", "simd",
+              "quality", "ns/voice-frame", "voices/core", "THD dB", "SNR dB");
+  double libmSnr = 0.0, tableSnr = 0.0, fixedSnr = 0.0;
+  double tierSnr[3] = {};
+  for (const auto &row : rows) {
+    const bool poly = row.backend == OscillatorBackend::Polynomial;
+    const SimdLevel simd =
+        poly ? kernels::resolveSimdLevel(row.simd) : SimdLevel::Scalar;
+    const double ns = synthNsPerVoiceFrame(row.backend, row.simd, row.quality);
+    const ToneQuality q = measureTone(row.backend, row.simd, row.quality);
+    std::printf("%-8s %-8s %-10s %14.3f %14.0f %10.2f %10.2f\n",
+                oscillatorBackendName(row.backend), kernels::simdLevelName(simd),
+                poly ? qualityTierName(row.quality) : "-", ns,
+                1e9 / (ns * SAMPLE_RATE), q.thdDb, q.snrDb);
+    if (row.backend == OscillatorBackend::Libm)
+      libmSnr = q.snrDb;
+    else if (row.backend == OscillatorBackend::Table)
+      tableSnr = q.snrDb;
+    else if (row.backend == OscillatorBackend::FixedPoint)
+      fixedSnr = q.snrDb;
+    else
+      tierSnr[static_cast<int>(row.quality)] = q.snrDb;
+  }
+  const double draftSnr = tierSnr[static_cast<int>(QualityTier::Draft)];
+  const double standardSnr = tierSnr[static_cast<int>(QualityTier::Standard)];
+  const double referenceSnr =
+      tierSnr[static_cast<int>(QualityTier::Reference)];
+  const bool ok = referenceSnr > 100.0 && referenceSnr > libmSnr + 3.0 &&
+                  referenceSnr > standardSnr + 3.0 &&
+                  standardSnr > draftSnr + 3.0 && tableSnr > draftSnr + 3.0 &&
+                  fixedSnr >= tableSnr;
+  std::printf("Backend accuracy ordering: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+const char *backgroundName(Period::Background bg) {
+  switch (bg) {
+  case Period::Background::None:
+    return "none";
+  case Period::Background::WhiteNoise:
+    return "white";
+  case Period::Background::PinkNoise:
+    return "pink";
+  }
+  return "unknown";
+}
+
+// 混音循环：通用（逐样本分支）与编译期特化对比，4 voices 使混音占主要开销。
+// 两者输出相差超过 1 LSB 时返回 false
+bool benchMixPaths() {
+  constexpr int MIX_VOICES = 4;
+  constexpr int MIX_REPEATS = 200;
+  std::printf("\nMix paths (%d voices, ns/frame)\n", MIX_VOICES);
+  std::printf("%-8s %-8s %12s %12s %10s %8s\n", "noise", "balance",
+              "generic", "specialized", "speedup", "max diff");
+  bool ok = true;
+  for (Period::Background bg :
+       {Period::Background::None, Period::Background::WhiteNoise,
+        Period::Background::PinkNoise}) {
+    for (float balance : {0.f, 0.5f}) {
+      Program program = toneProgram(MIX_VOICES, 100.f);
+      program.seq[0].background = bg;
+      program.seq[0].backgroundVol = 0.2f;
+      double ns[2];
+      std::vector<int16_t> out[2];
+      for (int specialized = 0; specialized < 2; ++specialized) {
+        SynthesizerConfig cfg;
+        cfg.specializedMix = specialized != 0;
+        Synthesizer synth(cfg);
+        synth.setProgram(program);
+        synth.setBalance(balance);
+        synth.fillSamples(out[specialized]);
+        const auto t0 = std::chrono::steady_clock::now();
+        std::vector<int16_t> buf;
+        for (int r = 0; r < MIX_REPEATS; ++r)
+          synth.fillSamples(buf);
+        const auto t1 = std::chrono::steady_clock::now();
+        ns[specialized] =
+            std::chrono::duration<double, std::nano>(t1 - t0).count() /
+            (static_cast<double>(MIX_REPEATS) * cfg.bufferFrames);
+      }
+      int maxDiff = 0;
+      for (size_t i = 0; i < out[0].size(); ++i)
+        maxDiff = std::max(maxDiff, std::abs(out[0][i] - out[1][i]));
+      if (maxDiff > 1)
+        ok = false;
+      std::printf("%-8s %-8.1f %12.3f %12.3f %9.2fx %8d\n",
+                  backgroundName(bg), balance, ns[0], ns[1], ns[0] / ns[1],
+                  maxDiff);
+    }
+  }
+  // Gnaural 纯粉红噪声条目：voice 音量为 0，只剩噪声生成与混音
+  Program noiseOnly = toneProgram(MIX_VOICES, 100.f);
+  for (auto &v : noiseOnly.seq[0].voices)
+    v.volume = 0.f;
+  noiseOnly.seq[0].background = Period::Background::PinkNoise;
+  noiseOnly.seq[0].backgroundVol = 0.2f;
+  Synthesizer synth;
+  synth.setProgram(noiseOnly);
+  std::vector<int16_t> buf;
+  synth.fillSamples(buf);
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < MIX_REPEATS; ++r)
+    synth.fillSamples(buf);
+  const auto t1 = std::chrono::steady_clock::now();
+  std::printf("%-8s %-8s %12s %12.3f\n", "pink", "silent", "-",
+              std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                  (static_cast<double>(MIX_REPEATS) * buf.size() / 2));
+  std::printf("Mix paths: %s\n", ok ? "OK" : "MISMATCH");
+  return ok;
+}
+
+// 各档 sin2Pi 在 [-1, 1] 周期上的实测最大误差（相对 double 精确值）。
+// 网格 2^22 点加上区间端点附近的逐个 float，超出 maxSineError 时返回 false
+bool benchQualityTiers(const std::vector<VoiceCase> &cases) {
+  constexpr int GRID = 1 << 22;
+  const double twoPi = 2.0 * 3.14159265358979323846;
+  std::printf("\nQuality tiers (sin2Pi worst-case error; kernels vs libm)\n");
+  std::printf("%-10s %12s %12s %12s %14s\n", "tier", "sine err", "bound",
+              "kernel err", "ns/voice-frame");
+  bool ok = true;
+  for (QualityTier tier :
+       {QualityTier::Draft, QualityTier::Standard, QualityTier::Reference}) {
+    double worst = 0.0;
+    auto probe = [&](float phase) {
+      const double exact = std::sin(twoPi * static_cast<double>(phase));
+      worst = std::max(
+          worst, std::abs(static_cast<double>(kernels::sin2Pi(tier, phase)) -
+                          exact));
+    };
+    for (int i = -GRID; i <= GRID; ++i)
+      probe(static_cast<float>(i) / GRID);
+    for (float edge : {-1.f, -0.75f, -0.5f, -0.25f, 0.f, 0.25f, 0.5f, 0.75f,
+                       1.f}) {
+      float lo = edge, hi = edge;
+      for (int i = 0; i < 4096; ++i) {
+        lo = std::nextafter(lo, -2.f);
+        hi = std::nextafter(hi, 2.f);
+        probe(lo);
+        probe(hi);
+      }
+    }
+    const float bound = kernels::maxSineError(tier);
+    if (worst > bound)
+      ok = false;
+
+    const auto &k = kernels::selectKernels(SimdLevel::Auto, tier);
+    const float kernelErr = std::max(maxErrorVsLibm(k, false, cases),
+                                     maxErrorVsLibm(k, true, cases));
+    // 等时 voice 为载波与包络之积，误差最多叠加两次
+    if (kernelErr > 2.f * bound + kernels::MAX_VECTOR_ERROR)
+      ok = false;
+    std::printf("%-10s %12.3g %12.3g %12.3g %14.3f\n", qualityTierName(tier),
+                worst, bound, kernelErr, nsPerVoiceFrame(k, false, cases));
+  }
+  std::printf("Tier bounds: %s\n", ok ? "OK" : "EXCEEDED");
+  return ok;
+}
+
+// 逐样本扫频：两个 voice 各自沿不同的 freqStart -> freqEnd 变化（period 短于
+// 渐入渐出门限，无噪声）。不同 bufferFrames 的输出差不得超过 SWEEP_GRID_LSB，
+// 与按各自线性扫频的二次相位（double std::sin）解析参考之差不得超过
+// SWEEP_REF_LSB，两者均以 16-bit LSB 计
+bool benchFrequencySweep() {
+  constexpr double SWEEP_GRID_LSB = 3.0;
+  constexpr double SWEEP_REF_LSB = 3.0;
+  constexpr double TWO_PI = 2.0 * 3.14159265358979323846;
+  Program program;
+  program.name = "sweep";
+  Period period;
+  period.lengthSec = 4;
+  period.voices.push_back({.freqStart = 2.f,
+                           .freqEnd = 30.f,
+                           .volume = 1.f,
+                           .pitch = 220.f,
+                           .isochronic = false});
+  period.voices.push_back({.freqStart = 10.f,
+                           .freqEnd = 5.f,
+                           .volume = 0.5f,
+                           .pitch = 330.f,
+                           .isochronic = false});
+  program.seq.push_back(period);
+  const size_t frames =
+      static_cast<size_t>(period.lengthSec * SAMPLE_RATE) - 1;
+
+  auto run = [&](int bufferFrames) {
+    SynthesizerConfig cfg;
+    cfg.bufferFrames = bufferFrames;
+    Synthesizer synth(cfg);
+    synth.setProgram(program);
+    std::vector<float> out(frames * 2);
+    for (size_t f = 0; f < frames; f += static_cast<size_t>(bufferFrames)) {
+      const size_t n =
+          std::min(frames - f, static_cast<size_t>(bufferFrames));
+      synth.render(out.data() + f * 2, n);
+      synth.advanceFrames(n);
+    }
+    return out;
+  };
+  const std::vector<float> small = run(512);
+  const std::vector<float> large = run(4096);
+
+  double gridDiff = 0.0, refDiff = 0.0;
+  const double numVoices = static_cast<double>(period.voices.size());
+  for (size_t f = 0; f < frames; ++f) {
+    const double d = static_cast<double>(f);
+    double refL = 0.0, refR = 0.0;
+    for (const auto &v : period.voices) {
+      const double slope = (v.freqEnd - v.freqStart) /
+                           (period.lengthSec * static_cast<double>(SAMPLE_RATE));
+      const double cyclesA = (v.pitch + v.freqStart) * d / SAMPLE_RATE +
+                             0.5 * slope * d * d / SAMPLE_RATE;
+      const double cyclesB = v.pitch * d / SAMPLE_RATE;
+      const double gain = v.volume * 32767.0 / numVoices;
+      refL += gain * std::sin(TWO_PI * (cyclesA - std::floor(cyclesA)));
+      refR += gain * std::sin(TWO_PI * (cyclesB - std::floor(cyclesB)));
+    }
+    for (int c = 0; c < 2; ++c) {
+      const double a = small[f * 2 + c] * 32768.0;
+      const double b = large[f * 2 + c] * 32768.0;
+      gridDiff = std::max(gridDiff, std::abs(a - b));
+      refDiff = std::max(refDiff, std::abs(a - (c == 0 ? refL : refR)));
+    }
+  }
+
+  const bool ok = gridDiff <= SWEEP_GRID_LSB && refDiff <= SWEEP_REF_LSB;
+  std::printf("\nFrequency sweep (2 voices, 2->30 Hz and 10->5 Hz over %g s)\n",
+              period.lengthSec);
+  std::printf("%-14s %14s\n", "512 vs 4096", "vs analytic");
+  std::printf("%-14.3g %14.3g\n", gridDiff, refDiff);
+  std::printf("Frequency sweep: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 24 小时浸泡：像实时回调一样每 buffer 推进一次样本时钟，在每个整点前后
+// 连续渲染 SOAK_WINDOW_SEC 秒，模拟一整天的播放。单个 24 h 扫频 period 在
+// 各窗口内逐样本与 double 解析参考之差不超过 SOAK_REF_LSB（窗口内的跳变
+// 同样会被发现）；循环播放的小数时长 program 在窗口内每个 buffer 的时钟
+// 位置与整数累计一致，整段输出与 seekProgram 到窗口起点后连续渲染逐位一致。
+// 旧做法（float 逐 buffer 累加秒数）一天后的偏差仅作对照
+bool benchSoak() {
+  constexpr int SOAK_HOURS = 24;
+  constexpr double SOAK_REF_LSB = 3.0;
+  constexpr int SOAK_WINDOW_SEC = 60;
+  constexpr double TWO_PI = 2.0 * 3.14159265358979323846;
+  const SynthesizerConfig cfg;
+  const uint64_t bufferFrames = static_cast<uint64_t>(cfg.bufferFrames);
+  const uint64_t hourFrames = 3600ull * static_cast<uint64_t>(cfg.sampleRate);
+  const uint64_t buffers = SOAK_HOURS * hourFrames / bufferFrames;
+  const uint64_t windowBuffers =
+      SOAK_WINDOW_SEC * static_cast<uint64_t>(cfg.sampleRate) / bufferFrames;
+
+  // 一个 period 覆盖整天，节拍 10 -> 2 Hz
+  Program day;
+  day.name = "day";
+  Period whole;
+  whole.lengthSec = SOAK_HOURS * 3600.0;
+  whole.voices.push_back({.freqStart = 10.f,
+                          .freqEnd = 2.f,
+                          .volume = 1.f,
+                          .pitch = 180.f,
+                          .isochronic = false});
+  day.seq.push_back(whole);
+
+  // 小数时长的扫频 period 与粉红噪声，一天内循环数百轮
+  Program loop;
+  loop.name = "loop";
+  for (const auto &[length, from, to] :
+       {std::tuple{61.7, 12.f, 4.f}, std::tuple{0.35, 4.f, 4.f},
+        std::tuple{93.123, 4.f, 9.f}}) {
+    Period period;
+    period.lengthSec = length;
+    period.voices.push_back({.freqStart = from,
+                             .freqEnd = to,
+                             .volume = 0.8f,
+                             .pitch = 210.f,
+                             .isochronic = false});
+    period.background = Period::Background::PinkNoise;
+    period.backgroundVol = 0.2f;
+    loop.seq.push_back(period);
+  }
+  uint64_t loopFrames = 0;
+  for (const Period &period : loop.seq)
+    loopFrames += static_cast<uint64_t>(periodFrames(period, cfg.sampleRate));
+
+  Synthesizer daySynth(cfg);
+  daySynth.setProgram(day);
+  Synthesizer loopSynth(cfg);
+  loopSynth.setProgram(loop);
+  Synthesizer seeker(cfg);
+  seeker.setProgram(loop);
+  std::vector<int16_t> out(bufferFrames * 2);
+  std::vector<int16_t> seeked(bufferFrames * 2);
+
+  const BinauralBeatVoice &v = day.seq[0].voices[0];
+  const double sweepHzPerSec =
+      (static_cast<double>(v.freqEnd) - v.freqStart) / whole.lengthSec;
+  double refDiff = 0.0;
+  int clockErrors = 0;
+  int seekDiff = 0;
+  float legacySec = 0.f;
+  const float legacyDelta = static_cast<float>(cfg.bufferFrames) / cfg.sampleRate;
+  // 窗口以整点为中心；一天结束处在 period 的渐出里，不设窗口
+  uint64_t nextMark = hourFrames - windowBuffers / 2 * bufferFrames;
+  const uint64_t lastMark = buffers * bufferFrames - hourFrames / 2;
+  uint64_t windowLeft = 0;
+  uint64_t rendered = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint64_t b = 0; b < buffers; ++b) {
+    const uint64_t frame = b * bufferFrames;
+    if (windowLeft == 0 && frame >= nextMark && frame < lastMark) {
+      nextMark += hourFrames;
+      windowLeft = windowBuffers;
+      seeker.seekProgram(frame);
+    }
+    if (windowLeft > 0) {
+      --windowLeft;
+      ++rendered;
+      // 扫频 period：参考相位为频率的积分，在 double 下直接按秒求
+      daySynth.render(out.data(), bufferFrames);
+      for (uint64_t f = 0; f < bufferFrames; ++f) {
+        const double t = static_cast<double>(frame + f) / cfg.sampleRate;
+        const double b0 = v.freqStart;
+        const double hzB = v.pitch;
+        const double a = (hzB + b0) * t + 0.5 * sweepHzPerSec * t * t;
+        const double refL = 32767.0 * std::sin(TWO_PI * (a - std::floor(a)));
+        const double c = hzB * t;
+        const double refR = 32767.0 * std::sin(TWO_PI * (c - std::floor(c)));
+        refDiff = std::max(refDiff, std::abs(out[f * 2] - refL));
+        refDiff = std::max(refDiff, std::abs(out[f * 2 + 1] - refR));
+      }
+      // 循环 program：时钟与整数累计一致，输出与 seek 后连续渲染一致
+      if (loopSynth.programFrame() != frame % loopFrames)
+        ++clockErrors;
+      loopSynth.render(out.data(), bufferFrames);
+      seeker.render(seeked.data(), bufferFrames);
+      for (size_t i = 0; i < out.size(); ++i)
+        seekDiff = std::max(seekDiff, std::abs(out[i] - seeked[i]));
+    }
+    daySynth.advanceFrames(bufferFrames);
+    loopSynth.advanceFrames(bufferFrames);
+    legacySec += legacyDelta;
+  }
+  const double wallSec = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - t0)
+                             .count();
+  const uint64_t total = buffers * bufferFrames;
+  if (daySynth.programFrame() != total % static_cast<uint64_t>(
+                                            periodFrames(whole, cfg.sampleRate)))
+    ++clockErrors;
+  if (loopSynth.programFrame() != total % loopFrames)
+    ++clockErrors;
+  const double legacyDrift =
+      static_cast<double>(legacySec) -
+      static_cast<double>(total) / cfg.sampleRate;
+
+  const bool ok = refDiff <= SOAK_REF_LSB && clockErrors == 0 && seekDiff == 0;
+  std::printf("\nSoak (%d h simulated, %llu buffers, %llu rendered around the "
+              "hours, in %.2f s)\n",
+              SOAK_HOURS, static_cast<unsigned long long>(buffers),
+              static_cast<unsigned long long>(rendered), wallSec);
+  std::printf("%-12s %10s %10s %14s\n", "vs analytic", "clock", "loop seek",
+              "float drift s");
+  std::printf("%-12.3g %10d %10d %14.3f\n", refDiff, clockErrors, seekDiff,
+              legacyDrift);
+  std::printf("Soak: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 回调统计：按已知的耗时与标志序列 record，计数、直方图、负载与截止时间
+// 统计须与序列一致；record 在 RealtimeScope 内测开销（Debug 下检查不分配）
+bool benchAudioStats() {
+  constexpr int CALLBACKS = 1000;
+  constexpr uint64_t BUDGET_NS = 2048ull * 1'000'000'000ull / 44100;
+  AudioStats stats;
+  uint64_t expectBuckets[AudioStats::BUCKETS] = {};
+  uint64_t misses = 0, underflows = 0, overflows = 0, maxNs = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  {
+    RealtimeScope realtime;
+    for (int i = 0; i < CALLBACKS; ++i) {
+      // 1 µs .. 约 65 ms 的几何序列，末尾几次超出预算
+      const uint64_t ns = 1000ull << (i % 17);
+      const bool under = i % 97 == 0;
+      const bool over = i % 331 == 0;
+      stats.record(ns, BUDGET_NS, under, over);
+      ++expectBuckets[AudioStats::bucketOf(ns)];
+      misses += ns > BUDGET_NS;
+      underflows += under;
+      overflows += over;
+      maxNs = std::max(maxNs, ns);
+    }
+  }
+  const double recordNs = std::chrono::duration<double, std::nano>(
+                              std::chrono::steady_clock::now() - t0)
+                              .count() /
+                          CALLBACKS;
+  const AudioStatsSnapshot snap = stats.snapshot();
+  bool ok = snap.callbacks == CALLBACKS && snap.deadlineMisses == misses &&
+            snap.underflows == underflows && snap.overflows == overflows &&
+            snap.xruns() == underflows + overflows &&
+            snap.maxRenderUs == static_cast<double>(maxNs) * 1e-3 &&
+            std::abs(snap.maxLoad - static_cast<double>(maxNs) / BUDGET_NS) <
+                1e-3 &&
+            AudioStats::bucketOf(0) == 0 && AudioStats::bucketOf(1999) == 0 &&
+            AudioStats::bucketOf(2000) == 1 &&
+            AudioStats::bucketOf(~0ull) == AudioStats::BUCKETS - 1;
+  for (size_t b = 0; b < AudioStats::BUCKETS; ++b)
+    ok = ok && snap.histogram[b] == expectBuckets[b];
+  stats.reset();
+  ok = ok && stats.snapshot().callbacks == 0 && stats.snapshot().maxLoad == 0;
+
+  std::printf("\nAudio stats (%d callbacks)\n", CALLBACKS);
+  std::printf("%-12s %10s %10s %10s %10s\n", "record ns", "late", "xruns",
+              "max load", "avg load");
+  std::printf("%-12.1f %10llu %10llu %9.0f%% %9.0f%%\n", recordNs,
+              static_cast<unsigned long long>(snap.deadlineMisses),
+              static_cast<unsigned long long>(snap.xruns()),
+              snap.maxLoad * 100.0, snap.load * 100.0);
+  std::printf("Audio stats: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 追踪：两个线程在 RealtimeScope 内各写满一圈环形缓冲（检查回绕后只留最近
+// EVENTS_PER_THREAD 个），其间并发导出一次；随后依次起 2 * MAX_THREADS 个
+// 短命线程各记一个事件（releaseThread 后缓冲可再借），并由另一线程按线程号
+// 归还一个仍存活线程的缓冲；主线程渲染带粉红噪声的
+// buffer，导出的 JSON 须含 fillSamples 各阶段。未启用追踪的构建只检查
+// dump 返回 false
+bool benchTrace() {
+  if (!trace::ENABLED) {
+    const bool ok = !trace::dump("binaural_trace_disabled.json");
+    std::printf("\nTrace: compiled out (configure with -DBINAURAL_TRACE=ON): "
+                "%s\n",
+                ok ? "OK" : "FAILED");
+    return ok;
+  }
+
+  constexpr int WORKERS = 2;
+  constexpr size_t PER_WORKER = trace::EVENTS_PER_THREAD + 500;
+  constexpr int BUFFERS = 8;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "binaural_bench_trace.json")
+          .string();
+
+  BINAURAL_TRACE_THREAD("bench main");
+  SynthesizerConfig config;
+  Program program = toneProgram(4, 200.f);
+  program.seq[0].background = Period::Background::PinkNoise;
+  program.seq[0].backgroundVol = 0.2f;
+  Synthesizer synth(config);
+  synth.setProgram(program);
+  std::vector<int16_t> buf;
+  synth.fillSamples(buf);
+  for (int b = 0; b < BUFFERS; ++b) {
+    RealtimeScope realtime;
+    synth.fillSamples(buf);
+    synth.advanceFrames(static_cast<uint64_t>(config.bufferFrames));
+  }
+
+  [[maybe_unused]] static const char *const NAMES[WORKERS] = {"bench worker 1",
+                                             "bench worker 2"};
+  std::atomic<int> started{0}, finished{0};
+  std::atomic<uint64_t> workerNs{0};
+  std::vector<std::thread> workers;
+  for (int w = 0; w < WORKERS; ++w) {
+    workers.emplace_back([&, w] {
+      BINAURAL_TRACE_THREAD(NAMES[w]);
+      started.fetch_add(1);
+      const uint64_t t0 = trace::nowNs();
+      {
+        RealtimeScope realtime;
+        for (size_t i = 0; i < PER_WORKER; ++i) {
+          BINAURAL_TRACE_SCOPE("bench scope");
+        }
+      }
+      workerNs.fetch_add(trace::nowNs() - t0);
+      // 都写完再退出，免得先退出的线程归还的环被另一个接着写
+      finished.fetch_add(1);
+      while (finished.load() < WORKERS)
+        std::this_thread::yield();
+      trace::releaseThread();
+    });
+  }
+  while (started.load() < WORKERS)
+    std::this_thread::yield();
+  bool ok = trace::dump(path);  // 与写入并发
+  for (auto &t : workers)
+    t.join();
+  ok = trace::dump(path) && ok;
+
+  std::ifstream in(path);
+  std::string line, first, last;
+  size_t scopes = 0, reused = 0, named = 0, stages[4] = {};
+  static const char *const STAGES[4] = {"fillSamples", "oscillators", "noise",
+                                        "mix + convert"};
+  while (std::getline(in, line)) {
+    if (first.empty())
+      first = line;
+    last = line;
+    if (line.find("\"name\":\"bench scope\",\"ph\":\"X\"") != std::string::npos)
+      ++scopes;
+    if (line.find("\"ph\":\"M\"") != std::string::npos &&
+        line.find("bench ") != std::string::npos)
+      ++named;
+    for (int k = 0; k < 4; ++k) {
+      const std::string key = std::string("\"name\":\"") + STAGES[k] + "\"";
+      if (line.find(key) != std::string::npos)
+        ++stages[k];
+    }
+  }
+  in.close();
+
+  // 归还的缓冲可再借：之后的线程可以继续记录（接着写同一个环）
+  constexpr size_t REUSE = 2 * trace::MAX_THREADS;
+  for (size_t i = 0; i < REUSE; ++i) {
+    std::thread([] {
+      { BINAURAL_TRACE_SCOPE("bench reuse"); }
+      trace::releaseThread();
+    }).join();
+  }
+  // 按线程号归还（音频驱动停止时的做法）：借用者之后再记录时重新借用，
+  // 不会写进已被别人借走的环
+  std::atomic<int> phase{0};
+  std::atomic<uint32_t> holder{0};
+  std::thread held([&] {
+    { BINAURAL_TRACE_SCOPE("bench reuse"); }
+    holder.store(trace::threadId());
+    phase.store(1);
+    while (phase.load() < 2)
+      std::this_thread::yield();
+    { BINAURAL_TRACE_SCOPE("bench reuse"); }
+    trace::releaseThread();
+  });
+  while (phase.load() < 1)
+    std::this_thread::yield();
+  trace::releaseThread(holder.load());
+  std::thread([] {
+    { BINAURAL_TRACE_SCOPE("bench reuse"); }
+    trace::releaseThread();
+  }).join();
+  phase.store(2);
+  held.join();
+  ok = trace::dump(path) && ok;
+  in.open(path);
+  while (std::getline(in, line)) {
+    if (line.find("\"name\":\"bench reuse\"") != std::string::npos)
+      ++reused;
+  }
+  in.close();
+  std::filesystem::remove(path);
+  ok = ok && first.rfind("{\"displayTimeUnit\"", 0) == 0 && last == "]}" &&
+       scopes == WORKERS * trace::EVENTS_PER_THREAD && reused == REUSE + 3 &&
+       named == WORKERS + 1 && stages[0] >= BUFFERS + 1;
+  for (size_t n : stages)
+    ok = ok && n > 0;
+
+  std::printf("\nTrace (%d threads x %zu scopes, ring %zu)\n", WORKERS,
+              PER_WORKER, trace::EVENTS_PER_THREAD);
+  std::printf("%-12s %10s %10s %10s %10s\n", "scope ns", "kept", "reused",
+              "threads", "stages");
+  std::printf("%-12.1f %10zu %10zu %10zu %10zu\n",
+              static_cast<double>(workerNs.load()) / (WORKERS * PER_WORKER),
+              scopes, reused, named, stages[1] + stages[2] + stages[3]);
+  std::printf("Trace: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 快照须是连续的一段：前缀为 0（尚未写到），其后逐帧加 1，右声道为左声道取反
+bool waveformSnapshotValid(const std::vector<float> &l,
+                           const std::vector<float> &r) {
+  size_t i = 0;
+  while (i < l.size() && l[i] == 0.f && r[i] == 0.f)
+    ++i;
+  for (size_t j = i; j < l.size(); ++j) {
+    if (r[j] != -l[j] || (j > i && l[j] != l[j - 1] + 1.f))
+      return false;
+  }
+  return true;
+}
+
+// WaveformBuffer：单线程下的回绕与超长块；并发时写线程在 RealtimeScope 内
+// 按块写入递增序列，读线程连续取快照，校验通过（返回 true）的快照必须连续
+bool benchWaveformBuffer() {
+  constexpr int BLOCKS = 3000;
+  constexpr size_t BLOCK = 512;
+  bool ok = true;
+  {
+    WaveformBuffer wave(64);
+    std::vector<float> l(200), r(200), outL, outR;
+    for (size_t i = 0; i < l.size(); ++i) {
+      l[i] = static_cast<float>(i + 1);
+      r[i] = -l[i];
+    }
+    wave.pushBlock(l.data(), r.data(), 10);
+    ok = ok && wave.getSamples(outL, outR) && outL.size() == 64 &&
+         outL[53] == 0.f && outL[54] == 1.f && outL[63] == 10.f &&
+         waveformSnapshotValid(outL, outR);
+    for (size_t i = 10; i < 20; ++i)
+      wave.push(l[i], r[i]);
+    wave.pushBlock(l.data() + 20, r.data() + 20, 180);
+    ok = ok && wave.written() == 200 && wave.getSamples(outL, outR) &&
+         outL.front() == 137.f && outL.back() == 200.f &&
+         waveformSnapshotValid(outL, outR);
+  }
+
+  WaveformBuffer wave(4096);
+  std::atomic<bool> done{false};
+  double pushNs = 0.0;
+  std::thread writer([&] {
+    float l[BLOCK], r[BLOCK];
+    float next = 1.f;
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+      RealtimeScope realtime;
+      for (int b = 0; b < BLOCKS; ++b) {
+        for (size_t i = 0; i < BLOCK; ++i) {
+          l[i] = next;
+          r[i] = -next;
+          next += 1.f;
+        }
+        wave.pushBlock(l, r, BLOCK);
+      }
+    }
+    pushNs = std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - t0)
+                 .count() /
+             (static_cast<double>(BLOCKS) * BLOCK);
+    done.store(true, std::memory_order_release);
+  });
+  size_t reads = 0, torn = 0, broken = 0;
+  std::vector<float> outL, outR;
+  while (!done.load(std::memory_order_acquire)) {
+    ++reads;
+    if (!wave.getSamples(outL, outR))
+      ++torn;
+    else if (!waveformSnapshotValid(outL, outR))
+      ++broken;
+  }
+  writer.join();
+  ok = ok && broken == 0 && wave.getSamples(outL, outR) &&
+       outL.back() == static_cast<float>(BLOCKS * BLOCK) &&
+       waveformSnapshotValid(outL, outR);
+
+  std::printf("\nWaveformBuffer (%d blocks x %zu frames, concurrent reader)\n",
+              BLOCKS, BLOCK);
+  std::printf("%-16s %10s %10s %10s\n", "write ns/frame", "reads", "torn",
+              "broken");
+  std::printf("%-16.2f %10zu %10zu %10zu\n", pushNs, reads, torn, broken);
+  std::printf("WaveformBuffer: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 与 WaveformPyramid::readEnvelope 相同的列划分：第 c 列覆盖的帧范围
+// 向外扩展到整 bin，再裁到可用历史 [oldest, end)
+std::pair<int64_t, int64_t> envelopeColumnFrames(const PeakWindow &w,
+                                                 uint64_t windowFrames,
+                                                 size_t columns, size_t c,
+                                                 int64_t oldest) {
+  const int64_t bin = static_cast<int64_t>(w.binFrames);
+  const int64_t end = static_cast<int64_t>(w.endFrame);
+  const int64_t span = static_cast<int64_t>(windowFrames);
+  const int64_t cols = static_cast<int64_t>(columns);
+  const int64_t i = static_cast<int64_t>(c);
+  const int64_t from = end - span + i * span / cols;
+  const int64_t to = end - span + (i + 1) * span / cols;
+  int64_t f0 = (from >= 0 ? from / bin : -((-from + bin - 1) / bin)) * bin;
+  int64_t f1 = std::max(f0 + bin, (to + bin - 1) / bin * bin);
+  return {std::max(f0, oldest), std::min(f1, end)};
+}
+
+// WaveformPyramid：随机长度的块写入随机信号，各窗口 / 列数下的包络须与
+// 原始样本在相同帧范围上的 min/max 逐位一致（含历史被覆写后的最旧列）；
+// 并发时写线程写入帧号斜坡，读到的每列 min/max 须恰为该列首尾帧号
+bool benchWaveformPyramid() {
+  bool ok = true;
+  size_t compared = 0;
+  {
+    WaveformPyramid peaks(64, 4, 4);
+    const uint64_t frames = 100'000;
+    std::vector<float> l(frames), r(frames);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    for (uint64_t f = 0; f < frames; ++f) {
+      l[f] = dist(rng);
+      r[f] = dist(rng) * 0.5f;
+    }
+    std::uniform_int_distribution<size_t> blockLen(1, 3000);
+    std::vector<PeakColumn> cols(128);
+    for (uint64_t f = 0; f < frames;) {
+      const size_t n =
+          static_cast<size_t>(std::min<uint64_t>(blockLen(rng), frames - f));
+      peaks.pushBlock(l.data() + f, r.data() + f, n);
+      f += n;
+      for (uint64_t window : {1ull, 50ull, 500ull, 5000ull, 16000ull, 40000ull}) {
+        for (size_t columns : {size_t{1}, size_t{7}, size_t{64}, size_t{128}}) {
+          PeakWindow w;
+          if (!peaks.readEnvelope(window, cols.data(), columns, &w))
+            ok = false;
+          const int64_t done = static_cast<int64_t>(w.endFrame / w.binFrames);
+          const int64_t oldest =
+              std::max<int64_t>(done - static_cast<int64_t>(peaks.binsPerLevel()),
+                                0) *
+              static_cast<int64_t>(w.binFrames);
+          for (size_t c = 0; c < columns; ++c) {
+            const auto [f0, f1] =
+                envelopeColumnFrames(w, window, columns, c, oldest);
+            PeakColumn expect;
+            if (f0 < f1) {
+              expect.minL = *std::min_element(&l[f0], &l[f1]);
+              expect.maxL = *std::max_element(&l[f0], &l[f1]);
+              expect.minR = *std::min_element(&r[f0], &r[f1]);
+              expect.maxR = *std::max_element(&r[f0], &r[f1]);
+            }
+            ok = ok && cols[c].minL == expect.minL &&
+                 cols[c].maxL == expect.maxL && cols[c].minR == expect.minR &&
+                 cols[c].maxR == expect.maxR;
+            ++compared;
+          }
+        }
+      }
+    }
+    ok = ok && peaks.levelFor(1000, 100) == 1 &&
+         peaks.levelFor(peaks.historyFrames() * 2, 1) == peaks.levels() - 1;
+  }
+
+  constexpr size_t COLUMNS = 512;
+  WaveformPyramid peaks;
+  const uint64_t total = uint64_t{1} << 23;  // 斜坡值须为精确的 float
+  std::atomic<bool> done{false};
+  double pushNs = 0.0;
+  std::thread writer([&] {
+    float l[2048], r[2048];
+    float next = 0.f;
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+      RealtimeScope realtime;
+      for (uint64_t f = 0; f < total; f += 2048) {
+        for (size_t i = 0; i < 2048; ++i) {
+          l[i] = next;
+          r[i] = -next;
+          next += 1.f;
+        }
+        peaks.pushBlock(l, r, 2048);
+      }
+    }
+    pushNs = std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - t0)
+                 .count() /
+             static_cast<double>(total);
+    done.store(true, std::memory_order_release);
+  });
+  std::vector<PeakColumn> cols(COLUMNS);
+  size_t reads = 0, torn = 0, broken = 0;
+  double readUs = 0.0;
+  const uint64_t windows[] = {20'000, 400'000, 6'000'000};
+  while (!done.load(std::memory_order_acquire)) {
+    const uint64_t window = windows[reads % 3];
+    PeakWindow w;
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool consistent =
+        peaks.readEnvelope(window, cols.data(), COLUMNS, &w);
+    readUs += std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - t0)
+                  .count();
+    ++reads;
+    if (!consistent) {
+      ++torn;
+      continue;
+    }
+    const int64_t oldest =
+        std::max<int64_t>(static_cast<int64_t>(w.endFrame / w.binFrames) -
+                              static_cast<int64_t>(peaks.binsPerLevel()),
+                          0) *
+        static_cast<int64_t>(w.binFrames);
+    for (size_t c = 0; c < COLUMNS; ++c) {
+      const auto [f0, f1] = envelopeColumnFrames(w, window, COLUMNS, c, oldest);
+      const bool match =
+          f0 < f1 ? cols[c].minL == static_cast<float>(f0) &&
+                        cols[c].maxL == static_cast<float>(f1 - 1) &&
+                        cols[c].maxR == -static_cast<float>(f0) &&
+                        cols[c].minR == -static_cast<float>(f1 - 1)
+                  : cols[c].minL == 0.f && cols[c].maxL == 0.f;
+      if (!match) {
+        ++broken;
+        break;
+      }
+    }
+  }
+  writer.join();
+  ok = ok && broken == 0 && peaks.written() == total;
+
+  std::printf("\nWaveformPyramid (%d levels x %zu bins, %.0f s history at "
+              "44.1 kHz)\n",
+              peaks.levels(), peaks.binsPerLevel(),
+              static_cast<double>(peaks.historyFrames()) / 44100.0);
+  std::printf("%-16s %14s %10s %10s %10s %10s\n", "write ns/frame",
+              "read us/512col", "reads", "torn", "broken", "compared");
+  std::printf("%-16.2f %14.2f %10zu %10zu %10zu %10zu\n", pushNs,
+              reads ? readUs / static_cast<double>(reads) : 0.0, reads, torn,
+              broken, compared);
+  std::printf("WaveformPyramid: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 相邻样本差的最大值（两声道分别计），衡量阶跃/爆音
+int maxSampleStep(const int16_t *samples, size_t frames) {
+  int step = 0;
+  for (size_t i = 2; i < frames * 2; ++i)
+    step = std::max(step, std::abs(samples[i] - samples[i - 2]));
+  return step;
+}
+
+// period 切换：一串不足一个 buffer 的短 period（含零时长）。大、小 buffer
+// 的输出都与按样本切换的解析参考（double std::sin，相位跨 period 连续）之差
+// 不超过 BOUNDARY_REF_LSB，每个 buffer 后的播放时钟与按样本数累计的位置一致。
+// 交叉淡化：音量跳变处相邻样本差不超过稳态加 RAMP_STEP_SLACK，seek 到淡化
+// 区间内与连续渲染逐位一致；循环播放到第二、三轮后 seek 同样逐位一致
+bool benchPeriodBoundaries() {
+  constexpr double BOUNDARY_REF_LSB = 3.0;
+  constexpr int RAMP_STEP_SLACK = 64;
+  constexpr double TWO_PI = 2.0 * 3.14159265358979323846;
+  const double lengths[] = {0.5, 0.02, 0.0, 0.75, 0.1, 1.25, 0.03, 0.4};
+  Program program;
+  program.name = "short";
+  for (size_t p = 0; p < std::size(lengths); ++p) {
+    Period period;
+    period.lengthSec = lengths[p];
+    const float beat = 4.f + static_cast<float>(p);
+    period.voices.push_back({.freqStart = beat,
+                             .freqEnd = beat,
+                             .volume = p % 2 ? 0.3f : 1.f,
+                             .pitch = 200.f + 40.f * p,
+                             .isochronic = false});
+    program.seq.push_back(period);
+  }
+  const int sampleRate = SynthesizerConfig{}.sampleRate;
+  std::vector<int64_t> starts{0};
+  for (const Period &period : program.seq)
+    starts.push_back(starts.back() + periodFrames(period, sampleRate));
+  const size_t frames = static_cast<size_t>(starts.back());
+
+  // 逐 buffer 渲染并检查 advanceFrames 后的播放时钟
+  int clockErrors = 0;
+  auto run = [&](const Program &prog, int bufferFrames, int crossfadeMs) {
+    SynthesizerConfig cfg;
+    cfg.bufferFrames = bufferFrames;
+    cfg.crossfadeMs = crossfadeMs;
+    Synthesizer synth(cfg);
+    synth.setProgram(prog);
+    std::vector<int16_t> out(frames * 2);
+    for (size_t f = 0; f < frames; f += static_cast<size_t>(bufferFrames)) {
+      const size_t n = std::min(frames - f, static_cast<size_t>(bufferFrames));
+      synth.render(out.data() + f * 2, n);
+      synth.advanceFrames(n);
+      const int64_t pos = static_cast<int64_t>((f + n) % frames);
+      const size_t p = static_cast<size_t>(
+          std::upper_bound(starts.begin(), starts.end() - 1, pos) -
+          starts.begin() - 1);
+      if (synth.currentPeriodIndex() != static_cast<int>(p) ||
+          static_cast<int64_t>(synth.periodFrame()) != pos - starts[p])
+        ++clockErrors;
+    }
+    return out;
+  };
+  const std::vector<int16_t> large = run(program, 16384, 0);
+  const std::vector<int16_t> small = run(program, 256, 0);
+
+  double refDiff = 0.0;
+  double cyclesA = 0.0, cyclesB = 0.0;
+  for (size_t p = 0; p < program.seq.size(); ++p) {
+    const BinauralBeatVoice &v = program.seq[p].voices[0];
+    const double hzA = static_cast<double>(v.pitch) + v.freqStart;
+    const double hzB = v.pitch;
+    const double gain = v.volume * 32767.0;
+    for (int64_t f = starts[p]; f < starts[p + 1]; ++f) {
+      const double d = static_cast<double>(f - starts[p]);
+      const double a = cyclesA + hzA * d / sampleRate;
+      const double b = cyclesB + hzB * d / sampleRate;
+      const double refL = gain * std::sin(TWO_PI * (a - std::floor(a)));
+      const double refR = gain * std::sin(TWO_PI * (b - std::floor(b)));
+      for (const std::vector<int16_t> *out : {&large, &small}) {
+        refDiff = std::max(refDiff, std::abs((*out)[f * 2] - refL));
+        refDiff = std::max(refDiff, std::abs((*out)[f * 2 + 1] - refR));
+      }
+    }
+    const double len = static_cast<double>(starts[p + 1] - starts[p]);
+    cyclesA += hzA * len / sampleRate;
+    cyclesB += hzB * len / sampleRate;
+  }
+
+  // 交叉淡化：同一音高、音量 1 -> 0.2 -> 1，切换点不在整周期上
+  Program steps;
+  steps.name = "steps";
+  for (float volume : {1.f, 0.2f, 1.f}) {
+    Period period;
+    period.lengthSec = 0.8137;
+    period.voices.push_back({.freqStart = 6.f,
+                             .freqEnd = 6.f,
+                             .volume = volume,
+                             .pitch = 300.f,
+                             .isochronic = false});
+    steps.seq.push_back(period);
+  }
+  const size_t stepFrames =
+      static_cast<size_t>(periodFrames(steps.seq[0], sampleRate));
+  auto renderSteps = [&](int crossfadeMs) {
+    SynthesizerConfig cfg;
+    cfg.crossfadeMs = crossfadeMs;
+    Synthesizer synth(cfg);
+    synth.setProgram(steps);
+    std::vector<int16_t> out(stepFrames * 3 * 2);
+    {
+      // 淡化尾部的 bank 与缓冲在构造/装入时备好，渲染中不分配
+      RealtimeScope realtime;
+      synth.render(out.data(), stepFrames * 3);
+    }
+    return out;
+  };
+  const std::vector<int16_t> hard = renderSteps(0);
+  const std::vector<int16_t> faded = renderSteps(20);
+  const int steadyStep = maxSampleStep(hard.data(), stepFrames - 1);
+  const int hardStep = maxSampleStep(hard.data(), stepFrames * 3);
+  const int fadeStep = maxSampleStep(faded.data(), stepFrames * 3);
+
+  SynthesizerConfig fadeCfg;
+  fadeCfg.crossfadeMs = 20;
+  Synthesizer seeker(fadeCfg);
+  seeker.setProgram(steps);
+  constexpr size_t SEEK_FRAMES = 1500;
+  std::vector<int16_t> window(SEEK_FRAMES * 2);
+  int seekDiff = 0;
+  for (size_t frame : {stepFrames + 77, stepFrames * 2 + 600}) {
+    seeker.seekProgram(frame);
+    seeker.render(window.data(), SEEK_FRAMES);
+    for (size_t i = 0; i < window.size(); ++i)
+      seekDiff = std::max(seekDiff, std::abs(window[i] - faded[frame * 2 + i]));
+  }
+
+  // 循环播放的第二、三轮：相位跨轮延续，中间 period 多一个只在轮内存在的
+  // voice。逐 buffer 连续播放与 seekProgram 到各轮须逐位一致
+  Program looped = steps;
+  looped.seq[1].voices.push_back({.freqStart = 3.f,
+                                  .freqEnd = 3.f,
+                                  .volume = 0.5f,
+                                  .pitch = 450.f,
+                                  .isochronic = false});
+  const size_t loopFrames = stepFrames * 3;
+  std::vector<int16_t> played(loopFrames * 3 * 2);
+  {
+    Synthesizer player(fadeCfg);
+    player.setProgram(looped);
+    const size_t bufferFrames = static_cast<size_t>(fadeCfg.bufferFrames);
+    for (size_t f = 0; f < loopFrames * 3; f += bufferFrames) {
+      const size_t n = std::min(loopFrames * 3 - f, bufferFrames);
+      player.render(played.data() + f * 2, n);
+      player.advanceFrames(n);
+    }
+  }
+  seeker.setProgram(looped);
+  int loopSeekDiff = 0;
+  for (size_t frame : {loopFrames + stepFrames + 77, loopFrames * 2 + 600,
+                       loopFrames * 2 + stepFrames * 2 + 600}) {
+    seeker.seekProgram(frame);
+    seeker.render(window.data(), SEEK_FRAMES);
+    for (size_t i = 0; i < window.size(); ++i)
+      loopSeekDiff =
+          std::max(loopSeekDiff, std::abs(window[i] - played[frame * 2 + i]));
+  }
+
+  const bool ok = refDiff <= BOUNDARY_REF_LSB && clockErrors == 0 &&
+                  fadeStep <= steadyStep + RAMP_STEP_SLACK && seekDiff == 0 &&
+                  loopSeekDiff == 0;
+  std::printf("\nPeriod boundaries (%zu periods, %.2f s; 20 ms crossfade)\n",
+              program.seq.size(), static_cast<double>(frames) / sampleRate);
+  std::printf("%-12s %10s %10s %10s %10s %10s %10s\n", "vs analytic", "clock",
+              "steady", "hard step", "faded step", "fade seek", "loop seek");
+  std::printf("%-12.3g %10d %10d %10d %10d %10d %10d\n", refDiff, clockErrors,
+              steadyStep, hardStep, fadeStep, seekDiff, loopSeekDiff);
+  std::printf("Period boundaries: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 参数平滑：在两个 buffer 之间改变音量、声像与节拍频率。
+// 过渡段相邻样本差不得超过稳态（原参数）的最大值加 RAMP_STEP_SLACK；
+// 音量/声像不影响相位与噪声，过渡结束后的输出须与一开始就用新值渲染的逐位一致。
+// 另以一个写线程与读线程直接检查节拍信箱的 seqlock 不会读到撕裂的快照
+bool benchParamSmoothing() {
+  constexpr int RAMP_STEP_SLACK = 64;
+  constexpr int BUFFERS = 8;
+  // 纯音用于相邻样本差，加噪声用于逐位比较
+  const Program tone = toneProgram(2, 440.f);
+  Program noisy = tone;
+  noisy.seq[0].background = Period::Background::WhiteNoise;
+  noisy.seq[0].backgroundVol = 0.1f;
+  SynthesizerConfig cfg;
+  const size_t bufferFrames = static_cast<size_t>(cfg.bufferFrames);
+  const size_t rampFrames = static_cast<size_t>(cfg.sampleRate) *
+                            Synthesizer::PARAM_RAMP_MS / 1000;
+
+  // 前 BUFFERS/2 个 buffer 用旧参数，之后用新参数
+  auto run = [&](const Program &program, bool change, bool beat,
+                 float volume, float balance) {
+    Synthesizer synth(cfg);
+    synth.setProgram(program);
+    synth.setVolumeMultiplier(volume);
+    synth.setBalance(balance);
+    std::vector<int16_t> out(bufferFrames * 2 * BUFFERS);
+    for (int b = 0; b < BUFFERS; ++b) {
+      if (change && b == BUFFERS / 2) {
+        if (beat) {
+          synth.setAllFreqs(12.f);
+        } else {
+          synth.setVolumeMultiplier(0.25f);
+          synth.setBalance(-0.8f);
+        }
+      }
+      RealtimeScope realtime;
+      synth.render(out.data() + b * bufferFrames * 2, bufferFrames);
+      synth.advanceFrames(bufferFrames);
+    }
+    return out;
+  };
+  const size_t changeFrame = bufferFrames * (BUFFERS / 2);
+  const std::vector<int16_t> steady = run(tone, false, false, 1.f, 0.f);
+  const std::vector<int16_t> ramped = run(tone, true, false, 1.f, 0.f);
+  const std::vector<int16_t> glided = run(tone, true, true, 1.f, 0.f);
+  const std::vector<int16_t> noisyRamped = run(noisy, true, false, 1.f, 0.f);
+  const std::vector<int16_t> target = run(noisy, false, false, 0.25f, -0.8f);
+  const int steadyStep = maxSampleStep(steady.data(), steady.size() / 2);
+  const int rampStep =
+      maxSampleStep(ramped.data() + (changeFrame - 1) * 2, rampFrames + 1);
+  const int glideStep =
+      maxSampleStep(glided.data() + (changeFrame - 1) * 2, rampFrames + 1);
+  const size_t settled = (changeFrame + rampFrames) * 2;
+  const bool settledSame =
+      std::equal(noisyRamped.begin() + settled, noisyRamped.end(),
+                 target.begin() + settled);
+
+  // seqlock：写者每次写入 count 个相同值，读者取到的快照必须一致
+  ParameterMailbox mailbox;
+  constexpr uint32_t POSTS = 200000;
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    BeatOverride beats;
+    beats.kind = BeatOverride::Kind::PerVoice;
+    beats.count = BeatOverride::MAX_VOICES;
+    for (uint32_t i = 1; i <= POSTS; ++i) {
+      std::fill(beats.hz, beats.hz + beats.count, static_cast<float>(i));
+      mailbox.postBeats(beats);
+      // 单核时也让读者穿插进来
+      if (i % 64 == 0)
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+  });
+  size_t taken = 0;
+  size_t torn = 0;
+  float last = 0.f;
+  BeatOverride beats;
+  for (;;) {
+    const bool finished = done.load(std::memory_order_acquire);
+    if (!mailbox.takeBeats(beats)) {
+      if (finished)
+        break;
+      continue;
+    }
+    ++taken;
+    if (!std::all_of(beats.hz, beats.hz + beats.count,
+                     [&](float v) { return v == beats.hz[0]; }) ||
+        beats.hz[0] < last)
+      ++torn;
+    last = beats.hz[0];
+  }
+  writer.join();
+  const bool latest = last == static_cast<float>(POSTS);
+
+  std::printf("\nParameter smoothing (%d ms ramps)\n",
+              Synthesizer::PARAM_RAMP_MS);
+  std::printf("%-12s %10s %10s %10s %10s\n", "steady step", "vol/bal",
+              "beat", "settled", "torn");
+  std::printf("%-12d %10d %10d %10s %6zu/%zu\n", steadyStep, rampStep,
+              glideStep, settledSame ? "same" : "DIFF", torn, taken);
+  const bool ok = rampStep <= steadyStep + RAMP_STEP_SLACK &&
+                  glideStep <= steadyStep + RAMP_STEP_SLACK && settledSame &&
+                  torn == 0 && latest;
+  std::printf("Parameter smoothing: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// program 热切换：发布线程不停发布两个不同规模的 program，音频循环每个
+// buffer 在 RealtimeScope 内 apply + render + advanceFrames（Debug 下任何分配或
+// 释放都会断言）。最后一次装入后的输出须与直接 setProgram 逐位一致，
+// 换下的状态须全部由回收方释放；同布局的连续发布不爆音
+bool benchProgramExchange() {
+  constexpr int PUBLISHES = 200;
+  constexpr size_t CHECK_FRAMES = 44100;
+  Program programs[2];
+  programs[0].name = "small";
+  programs[0].seq.push_back({
+      .lengthSec = 2,
+      .voices = {{.freqStart = 4.f, .freqEnd = 6.f, .volume = 0.7f,
+                  .pitch = 161.f, .isochronic = false}},
+      .background = Period::Background::PinkNoise,
+      .backgroundVol = 0.3f,
+  });
+  programs[0].seq.push_back({
+      .lengthSec = 3,
+      .voices = {{.freqStart = 6.f, .freqEnd = 6.f, .volume = 0.7f,
+                  .pitch = 161.f, .isochronic = true}},
+      .background = Period::Background::None,
+      .backgroundVol = 0.f,
+  });
+  programs[1].name = "large";
+  Period large;
+  large.lengthSec = 30;
+  for (int j = 0; j < 12; ++j)
+    large.voices.push_back({.freqStart = 7.5f,
+                            .freqEnd = 7.5f,
+                            .volume = 0.5f,
+                            .pitch = 100.f + 20.f * j,
+                            .isochronic = j % 3 == 0});
+  large.background = Period::Background::WhiteNoise;
+  large.backgroundVol = 0.1f;
+  programs[1].seq.push_back(large);
+
+  SynthesizerConfig cfg;
+  Synthesizer synth(cfg);
+  synth.setProgram(programs[0]);
+  ProgramExchange exchange(synth);
+  const size_t bufferFrames = static_cast<size_t>(cfg.bufferFrames);
+  std::vector<int16_t> buf(bufferFrames * 2);
+
+  std::atomic<bool> done{false};
+  std::thread publisher([&] {
+    for (int i = 0; i < PUBLISHES; ++i) {
+      exchange.publish(programs[(i + 1) % 2]);
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    done.store(true, std::memory_order_release);
+  });
+  double maxApplyUs = 0.0;
+  size_t buffers = 0;
+  auto step = [&] {
+    RealtimeScope realtime;
+    const auto t0 = std::chrono::steady_clock::now();
+    if (exchange.apply(synth))
+      maxApplyUs = std::max(
+          maxApplyUs, std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - t0)
+                          .count());
+    synth.render(buf.data(), bufferFrames);
+    synth.advanceFrames(bufferFrames);
+    ++buffers;
+  };
+  while (!done.load(std::memory_order_acquire))
+    step();
+  publisher.join();
+
+  // 再发布一次并立即装入（循环中可能已装入最后一次发布），与直接设置对比
+  const Program &last = programs[PUBLISHES % 2];
+  exchange.publish(last);
+  bool applied = false;
+  {
+    RealtimeScope realtime;
+    applied = exchange.apply(synth);
+  }
+  std::vector<int16_t> swapped(CHECK_FRAMES * 2);
+  std::vector<int16_t> direct(CHECK_FRAMES * 2);
+  Synthesizer reference(cfg);
+  reference.setProgram(last);
+  for (size_t f = 0; f + bufferFrames <= CHECK_FRAMES; f += bufferFrames) {
+    {
+      RealtimeScope realtime;
+      synth.render(swapped.data() + f * 2, bufferFrames);
+      synth.advanceFrames(bufferFrames);
+    }
+    reference.render(direct.data() + f * 2, bufferFrames);
+    reference.advanceFrames(bufferFrames);
+  }
+  exchange.reclaim();
+
+  const bool identical = applied && swapped == direct;
+  const bool reclaimed = exchange.applied() > 0 &&
+                         exchange.reclaimed() == exchange.applied();
+
+  // 参数编辑（GUI 滑块）：每个 buffer 发布一次节拍或基频改动。连续发布
+  // 保持播放位置、相位接续，相邻样本差不超过直接播放最终参数时的稳态加
+  // EDIT_STEP_SLACK；从起点重新开始的发布仅作对照
+  constexpr int EDITS = 64;
+  constexpr int EDIT_STEP_SLACK = 8;
+  Program edited = toneProgram(1, 161.f);
+  auto editAt = [&edited](int i) {
+    BinauralBeatVoice &v = edited.seq[0].voices[0];
+    if (i % 2 == 0) {
+      v.freqStart += 0.25f;
+      v.freqEnd = v.freqStart;
+    } else {
+      v.pitch += 0.5f;
+    }
+  };
+  const uint64_t editStart = static_cast<uint64_t>(10 * SAMPLE_RATE);
+  std::vector<int16_t> editOut(EDITS * bufferFrames * 2);
+  int editSteps[2] = {};
+  bool editKept = true;
+  for (const bool continuous : {true, false}) {
+    edited = toneProgram(1, 161.f);
+    Synthesizer editSynth(cfg);
+    editSynth.setProgram(edited);
+    editSynth.seekProgram(editStart);
+    ProgramExchange editExchange(editSynth);
+    for (int i = 0; i < EDITS; ++i) {
+      editAt(i);
+      editExchange.publish(edited, continuous);
+      RealtimeScope realtime;
+      editExchange.apply(editSynth);
+      editSynth.render(editOut.data() + i * bufferFrames * 2, bufferFrames);
+      editSynth.advanceFrames(bufferFrames);
+    }
+    editExchange.reclaim();
+    editSteps[continuous ? 0 : 1] =
+        maxSampleStep(editOut.data(), EDITS * bufferFrames);
+    if (continuous)
+      editKept = editSynth.programFrame() == editStart + EDITS * bufferFrames;
+  }
+  // edited 此时为最终参数
+  Synthesizer steadySynth(cfg);
+  steadySynth.setProgram(edited);
+  steadySynth.seekProgram(editStart);
+  steadySynth.render(editOut.data(), EDITS * bufferFrames);
+  const int steadyStep = maxSampleStep(editOut.data(), EDITS * bufferFrames);
+  const bool clickFree =
+      editKept && editSteps[0] <= steadyStep + EDIT_STEP_SLACK;
+
+  // 交叉淡化中编辑已播过的 period：正在发声与淡出中的 voice 都接续原相位，
+  // 输出与不编辑的相差不超过 FADE_EDIT_LSB（锚点换算的舍入）
+  constexpr int FADE_EDIT_LSB = 1;
+  Program faded;
+  faded.name = "fade edit";
+  for (float volume : {1.f, 0.2f, 1.f})
+    faded.seq.push_back({
+        .lengthSec = 0.8137,
+        .voices = {{.freqStart = 6.f, .freqEnd = 6.f, .volume = volume,
+                    .pitch = 300.f, .isochronic = false}},
+        .background = Period::Background::None,
+        .backgroundVol = 0.f,
+    });
+  SynthesizerConfig fadeCfg = cfg;
+  fadeCfg.crossfadeMs = 20;
+  const size_t fadeAt =
+      static_cast<size_t>(periodFrames(faded.seq[0], cfg.sampleRate)) * 2 +
+      200;
+  std::vector<int16_t> fadeOut[2];
+  for (const bool edit : {false, true}) {
+    Synthesizer fadeSynth(fadeCfg);
+    fadeSynth.setProgram(faded);
+    std::vector<int16_t> &out = fadeOut[edit ? 1 : 0];
+    out.resize((fadeAt + bufferFrames) * 2);
+    for (size_t f = 0; f < fadeAt; f += bufferFrames) {
+      const size_t n = std::min(fadeAt - f, bufferFrames);
+      fadeSynth.render(out.data() + f * 2, n);
+      fadeSynth.advanceFrames(n);
+    }
+    if (edit) {
+      Program changed = faded;
+      changed.seq[0].voices[0].freqStart = 9.f;
+      changed.seq[0].voices[0].freqEnd = 9.f;
+      ProgramExchange fadeExchange(fadeSynth);
+      fadeExchange.publish(changed, true);
+      fadeExchange.apply(fadeSynth);
+      fadeExchange.reclaim();
+    }
+    fadeSynth.render(out.data() + fadeAt * 2, bufferFrames);
+  }
+  int fadeEditDiff = 0;
+  for (size_t i = fadeAt * 2; i < fadeOut[0].size(); ++i)
+    fadeEditDiff = std::max(fadeEditDiff, std::abs(fadeOut[0][i] - fadeOut[1][i]));
+  std::printf("\nProgram exchange (%d publishes, %zu buffers)\n",
+              PUBLISHES + 1, buffers);
+  std::printf("%-10s %10s %10s %14s %10s\n", "published", "applied",
+              "reclaimed", "max apply us", "output");
+  std::printf("%-10llu %10llu %10llu %14.1f %10s\n",
+              static_cast<unsigned long long>(exchange.published()),
+              static_cast<unsigned long long>(exchange.applied()),
+              static_cast<unsigned long long>(exchange.reclaimed()),
+              maxApplyUs, identical ? "same" : "DIFF");
+  std::printf("%-10s %10s %10s %14s\n", "edits", "steady", "continuous",
+              "restart");
+  std::printf("%-10d %10d %10d %14d\n", EDITS, steadyStep, editSteps[0],
+              editSteps[1]);
+  std::printf("%-10s %10d\n", "fade edit", fadeEditDiff);
+  const bool ok = identical && reclaimed && clickFree &&
+                  fadeEditDiff <= FADE_EDIT_LSB;
+  std::printf("Program exchange: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
+// 离线渲染：单线程与多线程分块输出必须逐样本一致（含 32/64 帧的小 buffer）。
+// 节目覆盖 voice 数变化、静音 voice、三种背景噪声以及噪声中断后恢复
+bool benchOfflineRender() {
+  Program program;
+  program.name = "offline";
+  for (int per = 0; per < 4; ++per) {
+    Period period;
+    period.lengthSec = 20.f + per;
+    const int numVoices = per == 1 ? 5 : 7;
+    for (int j = 0; j < numVoices; ++j) {
+      BinauralBeatVoice v;
+      v.freqStart = 3.f + j + per;
+      v.freqEnd = 9.f - j;
+      v.volume = j == 4 ? 0.f : 0.5f;
+      v.pitch = j == 3 ? -1.f : 100.f + 37.f * j;
+      v.isochronic = (j + per) % 3 == 0;
+      period.voices.push_back(v);
+    }
+    period.background = per % 3 == 0 ? Period::Background::PinkNoise
+                        : per == 1   ? Period::Background::WhiteNoise
+                                     : Period::Background::None;
+    period.backgroundVol = 0.3f;
+    program.seq.push_back(period);
+  }
+
+  OfflineRenderer renderer(program, SynthesizerConfig{});
+  const double audioSec =
+      static_cast<double>(renderer.totalFrames()) / SAMPLE_RATE;
+  std::vector<int16_t> serial(renderer.totalFrames() * 2);
+  const auto t0 = std::chrono::steady_clock::now();
+  renderer.renderSerial(serial.data());
+  const auto t1 = std::chrono::steady_clock::now();
+  const double serialSec = std::chrono::duration<double>(t1 - t0).count();
+
+  std::printf("\nOffline render (%.0f s of audio, %llu buffers)\n", audioSec,
+              static_cast<unsigned long long>(renderer.totalBuffers()));
+  std::printf("%-8s %12s %12s %10s %8s\n", "threads", "seconds", "x realtime",
+              "speedup", "max diff");
+  std::printf("%-8s %12.3f %11.1fx %9.2fx %8d\n", "serial", serialSec,
+              audioSec / serialSec, 1.0, 0);
+
+  const int hw =
+      static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<int> threadCounts{1, 2, 4};
+  if (std::find(threadCounts.begin(), threadCounts.end(), hw) ==
+      threadCounts.end())
+    threadCounts.push_back(hw);
+  bool ok = true;
+  std::vector<int16_t> parallel(serial.size());
+  for (int threads : threadCounts) {
+    const auto p0 = std::chrono::steady_clock::now();
+    renderer.render(parallel.data(), threads);
+    const auto p1 = std::chrono::steady_clock::now();
+    const double sec = std::chrono::duration<double>(p1 - p0).count();
+    int maxDiff = 0;
+    for (size_t i = 0; i < serial.size(); ++i)
+      maxDiff = std::max(maxDiff, std::abs(serial[i] - parallel[i]));
+    if (maxDiff != 0)
+      ok = false;
+    std::printf("%-8d %12.3f %11.1fx %9.2fx %8d\n", threads, sec,
+                audioSec / sec, serialSec / sec, maxDiff);
+  }
+
+  // 文件导出：流式写入与内存映射两条路径，文件内容必须与 serial 一致
+  const auto tmpDir = std::filesystem::temp_directory_path();
+  const std::string streamPath = (tmpDir / "binaural_bench_stream.wav").string();
+  const std::string mappedPath = (tmpDir / "binaural_bench_mmap.wav").string();
+  const int sampleRate = SynthesizerConfig{}.sampleRate;
+  std::vector<char> expected(WAV_HEADER_SIZE);
+  makeWavHeader(expected.data(), sampleRate, 2, renderer.totalFrames());
+  expected.insert(expected.end(), reinterpret_cast<const char *>(serial.data()),
+                  reinterpret_cast<const char *>(serial.data() + serial.size()));
+  auto fileMatches = [&expected](const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+    std::filesystem::remove(path);
+    return bytes == expected;
+  };
+  {
+    const auto f0 = std::chrono::steady_clock::now();
+    WavWriter writer;
+    bool written = writer.open(streamPath, sampleRate) &&
+                   renderer.render([&writer](const int16_t *samples,
+                                             size_t frames) {
+                     return writer.write(samples, frames);
+                   }) &&
+                   writer.close();
+    const auto f1 = std::chrono::steady_clock::now();
+    MappedWavFile mapped;
+    if (mapped.create(mappedPath, sampleRate, renderer.totalFrames())) {
+      renderer.render(mapped.samples());
+      written = mapped.close() && written;
+    } else {
+      written = false;
+    }
+    const auto f2 = std::chrono::steady_clock::now();
+    const bool same = written && fileMatches(streamPath) &&
+                      fileMatches(mappedPath);
+    if (!same)
+      ok = false;
+    const double streamSec = std::chrono::duration<double>(f1 - f0).count();
+    const double mappedSec = std::chrono::duration<double>(f2 - f1).count();
+    std::printf("%-8s %12.3f %11.1fx %10s %8s\n", "stream", streamSec,
+                audioSec / streamSec, "-", same ? "0" : "FAIL");
+    std::printf("%-8s %12.3f %11.1fx %9.2fx %8s\n", "mmap", mappedSec,
+                audioSec / mappedSec, streamSec / mappedSec,
+                same ? "0" : "FAIL");
+  }
+
+  // 磁盘缓存：冷（全部未命中并写入）、热（全部命中）以及容量只够一半时
+  // 的 LRU 淘汰，三次输出都须与 serial 一致
+  {
+    const auto cacheDir = tmpDir / "binaural_bench_cache";
+    std::filesystem::remove_all(cacheDir);
+    const uint64_t fullBytes = serial.size() * sizeof(int16_t);
+    std::vector<int16_t> cached(serial.size());
+    bool same = true;
+    const char *names[] = {"cold", "warm", "evict"};
+    for (int pass = 0; pass < 3; ++pass) {
+      RenderCache cache(cacheDir.string(), pass < 2 ? RenderCache::DEFAULT_MAX_BYTES
+                                                    : fullBytes / 2);
+      OfflineRenderer cachedRenderer(program, SynthesizerConfig{});
+      cachedRenderer.setCache(&cache);
+      std::fill(cached.begin(), cached.end(), int16_t{0});
+      const auto c0 = std::chrono::steady_clock::now();
+      cachedRenderer.render(cached.data());
+      const double sec = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - c0)
+                             .count();
+      const RenderCacheStats &cs = cache.stats();
+      bool passOk = cached == serial;
+      if (pass == 1)
+        passOk = passOk && cs.misses == 0;
+      if (pass == 2)
+        passOk = passOk && cs.evictions > 0 && cache.sizeBytes() <= fullBytes / 2;
+      same = same && passOk;
+      std::printf("%-8s %12.3f %11.1fx %4llu/%-5llu %8s\n", names[pass], sec,
+                  audioSec / sec, static_cast<unsigned long long>(cs.hits),
+                  static_cast<unsigned long long>(cs.misses),
+                  passOk ? "0" : "FAIL");
+    }
+    std::filesystem::remove_all(cacheDir);
+    if (!same)
+      ok = false;
+  }
+
+  // 任意帧 seek：每个 period 内两处非 buffer 边界的位置，O(1) 定位后渲染
+  // 与连续渲染的对应样本比较，直接 seek 与经信箱的 setPeriodElapsedSec 各一次。
+  // 窗口不跨越 period 切换点
+  constexpr size_t SEEK_FRAMES = 3000;
+  const SynthesizerConfig cfg;
+  Synthesizer synth(cfg);
+  synth.setProgram(program);
+  std::vector<int16_t> window(SEEK_FRAMES * 2);
+  int seekDiff = 0;
+  uint64_t start = 0;
+  for (const Period &period : program.seq) {
+    const uint64_t length =
+        static_cast<uint64_t>(periodFrames(period, cfg.sampleRate));
+    for (uint64_t offset : {uint64_t{1001}, length / 2 + 333}) {
+      const uint64_t frame = start + offset;
+      synth.seekProgram(frame);
+      synth.render(window.data(), SEEK_FRAMES);
+      for (size_t i = 0; i < window.size(); ++i)
+        seekDiff = std::max(seekDiff,
+                            std::abs(window[i] - serial[frame * 2 + i]));
+      // 经信箱的 seek（GUI 用法）：下次 render 开始时才执行，之后发布的
+      // 时钟指向新位置
+      synth.seekProgram(start);
+      synth.setPeriodElapsedSec(static_cast<double>(offset) / cfg.sampleRate);
+      synth.render(window.data(), SEEK_FRAMES);
+      synth.advanceFrames(SEEK_FRAMES);
+      for (size_t i = 0; i < window.size(); ++i)
+        seekDiff = std::max(seekDiff,
+                            std::abs(window[i] - serial[frame * 2 + i]));
+      const uint64_t shown = static_cast<uint64_t>(
+          std::llround(synth.periodElapsedSec() * cfg.sampleRate));
+      if (synth.currentPeriodIndex() != &period - program.seq.data() ||
+          shown != offset + SEEK_FRAMES)
+        seekDiff = std::max(seekDiff, 1);
+    }
+    start += length;
+  }
+  if (seekDiff != 0)
+    ok = false;
+  std::printf("%-8s %12s %12s %10s %8d\n", "seek", "-", "-", "-", seekDiff);
+
+  // 短于一块的调用：块内已渲染的 voice 与粉红噪声留到下次调用，逐次取用
+  // 剩余帧。固定 64 帧与不规则长度的调用序列都须与 serial 一致，
+  // 64 帧调用的总耗时应与整块调用同一量级
+  for (const bool irregular : {false, true}) {
+    static constexpr size_t IRREGULAR[] = {1, 37, 511, 8, 1000, 64, 3};
+    Synthesizer chunked(cfg);
+    chunked.setProgram(program);
+    std::vector<int16_t> chunkOut(serial.size());
+    const auto c0 = std::chrono::steady_clock::now();
+    size_t done = 0;
+    for (size_t call = 0; done < renderer.totalFrames(); ++call) {
+      const size_t n = std::min<size_t>(
+          irregular ? IRREGULAR[call % std::size(IRREGULAR)] : 64,
+          renderer.totalFrames() - done);
+      chunked.render(chunkOut.data() + done * 2, n);
+      chunked.advanceFrames(n);
+      done += n;
+    }
+    const double sec = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - c0)
+                           .count();
+    int chunkDiff = 0;
+    for (size_t i = 0; i < serial.size(); ++i)
+      chunkDiff = std::max(chunkDiff, std::abs(chunkOut[i] - serial[i]));
+    if (chunkDiff != 0)
+      ok = false;
+    std::printf("%-8s %12.3f %11.1fx %9.2fx %8d\n",
+                irregular ? "mixed" : "64/call", sec, audioSec / sec,
+                serialSec / sec, chunkDiff);
+  }
+
+  // 小 buffer：粉红噪声滤波器定位按帧数补算，并行分块与 seek 的结果
+  // 不依赖 bufferFrames
+  for (int smallFrames : {32, 64}) {
+    SynthesizerConfig smallCfg;
+    smallCfg.bufferFrames = smallFrames;
+    OfflineRenderer small(program, smallCfg);
+    std::vector<int16_t> smallSerial(serial.size());
+    std::vector<int16_t> smallParallel(serial.size());
+    small.renderSerial(smallSerial.data());
+    small.render(smallParallel.data(), 4);
+    int smallDiff = 0;
+    for (size_t i = 0; i < serial.size(); ++i)
+      smallDiff =
+          std::max(smallDiff, std::abs(smallSerial[i] - smallParallel[i]));
+    Synthesizer smallSynth(smallCfg);
+    smallSynth.setProgram(program);
+    start = 0;
+    for (const Period &period : program.seq) {
+      const uint64_t length =
+          static_cast<uint64_t>(periodFrames(period, cfg.sampleRate));
+      for (uint64_t offset : {uint64_t{1001}, length / 2 + 333}) {
+        const uint64_t frame = start + offset;
+        smallSynth.seekProgram(frame);
+        smallSynth.render(window.data(), SEEK_FRAMES);
+        for (size_t i = 0; i < window.size(); ++i)
+          smallDiff = std::max(
+              smallDiff, std::abs(window[i] - smallSerial[frame * 2 + i]));
+      }
+      start += length;
+    }
+    if (smallDiff != 0)
+      ok = false;
+    char label[16];
+    std::snprintf(label, sizeof(label), "buf %d", smallFrames);
+    std::printf("%-8s %12s %12s %10s %8d\n", label, "-", "-", "-", smallDiff);
+  }
+  std::printf("Offline render: %s\n", ok ? "OK" : "MISMATCH");
+  return ok;
+}
+
+// ---- 基准套件（--suite）：只测性能，不做正确性检查。结果可写成 JSON，
+// 在版本之间对比回归 ----
+
+constexpr double SUITE_AUDIO_SEC = 1.0;
+constexpr int SUITE_MIN_BUFFERS = 16;
+constexpr int SUITE_REPEATS = 3;
+
+const char *noiseName(Period::Background noise) {
+  switch (noise) {
+  case Period::Background::WhiteNoise:
+    return "white";
+  case Period::Background::PinkNoise:
+    return "pink";
+  default:
+    return "none";
+  }
+}
+
+struct SynthResult {
+  int voices;
+  int bufferFrames;
+  bool isochronic;
+  Period::Background noise;
+  double nsPerFrame;
+  double realtimeFactor;
+};
+
+struct ParseResult {
+  const char *name;
+  size_t entries;
+  size_t bytes;
+  double usPerParse;
+};
+
+struct WaveformResult {
+  double pushNsIdle;       // 无读者时每次 push
+  double pushBlockNs;      // pushBlock 整块写入，折合每点
+  double pushNsContended;  // 读者连续 getSamples 时每次 push
+  double worstBufferUs;    // 竞争下单个 buffer 全部 push 的最长耗时
+  double getSamplesUs;
+  size_t reads;
+  size_t tornReads;        // 重试用尽仍被写者追上的读取
+};
+
+struct QueueResult {
+  double pushPopNs;  // 单线程 push + pop 一对
+  double mItemsPerSec;
+  size_t popped;
+  size_t pushed;
+};
+
+Program suiteProgram(int voices, bool isochronic, Period::Background noise) {
+  Program program;
+  program.name = "suite";
+  Period period;
+  period.lengthSec = 3600.0;
+  for (int j = 0; j < voices; ++j) {
+    const float beat = 2.f + 0.37f * static_cast<float>(j % 31);
+    period.voices.push_back({.freqStart = beat,
+                             .freqEnd = beat,
+                             .volume = 0.8f,
+                             .pitch = 120.f + 3.1f * static_cast<float>(j),
+                             .isochronic = isochronic});
+  }
+  period.background = noise;
+  period.backgroundVol = noise == Period::Background::None ? 0.f : 0.2f;
+  program.seq.push_back(period);
+  return program;
+}
+
+// 与实时回调相同的 fillSamples + advanceFrames，取 SUITE_REPEATS 次中最快的
+double fillSamplesNs(int voices, int bufferFrames, bool isochronic,
+                     Period::Background noise) {
+  SynthesizerConfig cfg;
+  cfg.bufferFrames = bufferFrames;
+  Synthesizer synth(cfg);
+  synth.setProgram(suiteProgram(voices, isochronic, noise));
+  std::vector<int16_t> buf;
+  const int buffers = std::max(
+      SUITE_MIN_BUFFERS,
+      static_cast<int>(std::ceil(SUITE_AUDIO_SEC * cfg.sampleRate /
+                                 bufferFrames)));
+  synth.fillSamples(buf);
+  double best = 1e300;
+  for (int r = 0; r < SUITE_REPEATS; ++r) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < buffers; ++b) {
+      synth.fillSamples(buf);
+      synth.advanceFrames(static_cast<uint64_t>(bufferFrames));
+    }
+    best = std::min(best, std::chrono::duration<double, std::nano>(
+                              std::chrono::steady_clock::now() - t0)
+                              .count());
+  }
+  return best / (static_cast<double>(buffers) * bufferFrames);
+}
+
+std::vector<SynthResult> suiteSynth() {
+  const int sampleRate = SynthesizerConfig{}.sampleRate;
+  std::vector<SynthResult> results;
+  auto add = [&](int voices, int bufferFrames, bool iso,
+                 Period::Background noise) {
+    const double ns = fillSamplesNs(voices, bufferFrames, iso, noise);
+    results.push_back(
+        {voices, bufferFrames, iso, noise, ns, 1e9 / (ns * sampleRate)});
+    const SynthResult &r = results.back();
+    std::printf("%6d %8d %-11s %-6s %12.2f %12.1f\n", r.voices, r.bufferFrames,
+                iso ? "isochronic" : "binaural", noiseName(noise), r.nsPerFrame,
+                r.realtimeFactor);
+  };
+  std::printf("\nfillSamples (%.0f s of audio per run, best of %d)\n",
+              SUITE_AUDIO_SEC, SUITE_REPEATS);
+  std::printf("%6s %8s %-11s %-6s %12s %12s\n", "voices", "buffer", "voice",
+              "noise", "ns/frame", "realtime x");
+  // 声部数 x buffer 长度的网格，不带噪声
+  for (bool iso : {false, true})
+    for (int voices : {1, 4, 16, 64, 256})
+      for (int bufferFrames : {32, 128, 512, 2048, 8192})
+        add(voices, bufferFrames, iso, Period::Background::None);
+  // 各噪声类型，典型声部数与 buffer
+  for (bool iso : {false, true})
+    for (Period::Background noise :
+         {Period::Background::WhiteNoise, Period::Background::PinkNoise})
+      for (int voices : {1, 16})
+        add(voices, 2048, iso, noise);
+  return results;
+}
+
+std::string gnauralPreset(size_t entries) {
+  std::string xml = "<?xml version=\"1.0\"?>\n<gnaural>\n"
+                    "<noisevol>12</noisevol>\n";
+  char line[256];
+  for (size_t i = 0; i < entries; ++i) {
+    std::snprintf(line, sizeof(line),
+                  "<entry parent=\"0\" duration=\"%.3f\" volume_left=\"0.80\" "
+                  "volume_right=\"0.75\" beatfreq=\"%.2f\" basefreq=\"%.1f\" "
+                  "state=\"1\"/>\n",
+                  30.0 + static_cast<double>(i % 97), 1.5 + (i % 23) * 0.5,
+                  120.0 + static_cast<double>(i % 11) * 10.0);
+    xml += line;
+  }
+  xml += "</gnaural>\n";
+  return xml;
+}
+
+std::vector<ParseResult> suiteParse() {
+  std::vector<ParseResult> results;
+  std::printf("\nparseGnauralFromString\n");
+  std::printf("%-8s %8s %10s %14s\n", "preset", "entries", "bytes",
+              "us/parse");
+  for (const auto &[name, entries, runs] :
+       {std::tuple{"small", size_t{12}, 200}, std::tuple{"huge", size_t{4000}, 3}}) {
+    const std::string xml = gnauralPreset(entries);
+    size_t parsed = 0;
+    double best = 1e300;
+    for (int r = 0; r < runs; ++r) {
+      const auto t0 = std::chrono::steady_clock::now();
+      const auto program = parseGnauralFromString(xml);
+      best = std::min(best, std::chrono::duration<double, std::micro>(
+                                std::chrono::steady_clock::now() - t0)
+                                .count());
+      parsed = program ? program->seq.size() : 0;
+    }
+    results.push_back({name, parsed, xml.size(), best});
+    std::printf("%-8s %8zu %10zu %14.1f\n", name, parsed, xml.size(), best);
+  }
+  return results;
+}
+
+// 写线程按 GUI 回调的方式每 buffer push bufferFrames/4 个点；读线程连续
+// getSamples，模拟最坏的 UI 刷新
+WaveformResult suiteWaveform() {
+  constexpr int BUFFERS = 2000;
+  constexpr int POINTS = 2048 / 4;
+  WaveformBuffer wave;
+  auto pushAll = [&wave](double *worstUs) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < BUFFERS; ++b) {
+      const auto b0 = std::chrono::steady_clock::now();
+      for (int i = 0; i < POINTS; ++i)
+        wave.push(static_cast<float>(i) * 1e-3f, -static_cast<float>(i) * 1e-3f);
+      if (worstUs)
+        *worstUs = std::max(*worstUs, std::chrono::duration<double, std::micro>(
+                                          std::chrono::steady_clock::now() - b0)
+                                          .count());
+    }
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - t0)
+               .count() /
+           (static_cast<double>(BUFFERS) * POINTS);
+  };
+
+  WaveformResult r{};
+  r.pushNsIdle = pushAll(nullptr);
+  {
+    std::vector<float> l(POINTS), rr(POINTS);
+    for (int i = 0; i < POINTS; ++i) {
+      l[i] = static_cast<float>(i) * 1e-3f;
+      rr[i] = -l[i];
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < BUFFERS; ++b)
+      wave.pushBlock(l.data(), rr.data(), POINTS);
+    r.pushBlockNs = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - t0)
+                        .count() /
+                    (static_cast<double>(BUFFERS) * POINTS);
+  }
+  std::atomic<bool> done{false};
+  double readUs = 0.0;
+  std::thread reader([&] {
+    std::vector<float> l, rr;
+    const auto t0 = std::chrono::steady_clock::now();
+    while (!done.load(std::memory_order_acquire)) {
+      if (!wave.getSamples(l, rr))
+        ++r.tornReads;
+      ++r.reads;
+    }
+    readUs = std::chrono::duration<double, std::micro>(
+                 std::chrono::steady_clock::now() - t0)
+                 .count();
+  });
+  r.pushNsContended = pushAll(&r.worstBufferUs);
+  done.store(true, std::memory_order_release);
+  reader.join();
+  r.getSamplesUs = r.reads ? readUs / static_cast<double>(r.reads) : 0.0;
+
+  std::printf("\nWaveformBuffer (%d buffers x %d points)\n", BUFFERS, POINTS);
+  std::printf("%-12s %12s %14s %16s %14s %10s %8s\n", "push ns",
+              "block ns", "contended ns", "worst buffer us", "getSamples us",
+              "reads", "torn");
+  std::printf("%-12.1f %12.2f %14.1f %16.1f %14.1f %10zu %8zu\n",
+              r.pushNsIdle, r.pushBlockNs, r.pushNsContended, r.worstBufferUs,
+              r.getSamplesUs, r.reads, r.tornReads);
+  return r;
+}
+
+QueueResult suiteQueue() {
+  constexpr size_t ITEMS = 2'000'000;
+  QueueResult r{};
+  {
+    LockFreeQueue<EEGStatePrediction, 8> queue;
+    EEGStatePrediction item{};
+    size_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITEMS; ++i) {
+      queue.push(item);
+      sink += queue.pop().has_value();
+    }
+    r.pushPopNs = std::chrono::duration<double, std::nano>(
+                      std::chrono::steady_clock::now() - t0)
+                      .count() /
+                  static_cast<double>(ITEMS);
+    if (sink != ITEMS)
+      r.pushPopNs = -1.0;
+  }
+  {
+    // 生产者满速写入（满时覆盖最旧），消费者逐个取，计两端吞吐
+    LockFreeQueue<EEGStatePrediction, 8> queue;
+    std::atomic<bool> done{false};
+    std::thread consumer([&] {
+      while (!done.load(std::memory_order_acquire) || !queue.empty())
+        r.popped += queue.pop().has_value();
+    });
+    EEGStatePrediction item{};
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITEMS; ++i)
+      queue.push(item);
+    const double sec = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - t0)
+                           .count();
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    r.pushed = ITEMS;
+    r.mItemsPerSec = static_cast<double>(ITEMS) / sec * 1e-6;
+  }
+  std::printf("\nLockFreeQueue<EEGStatePrediction, 8> (%zu items)\n", ITEMS);
+  std::printf("%-14s %14s %12s\n", "push+pop ns", "push M/s", "popped");
+  std::printf("%-14.2f %14.1f %12zu\n", r.pushPopNs, r.mItemsPerSec, r.popped);
+  return r;
+}
+
+bool writeSuiteJson(const std::string &path,
+                    const std::vector<SynthResult> &synth,
+                    const std::vector<ParseResult> &parse,
+                    const WaveformResult &wave, const QueueResult &queue) {
+  std::ofstream out(path);
+  if (!out)
+    return false;
+  char buf[512];
+  auto emit = [&](const char *fmt, auto... args) {
+    std::snprintf(buf, sizeof(buf), fmt, args...);
+    out << buf;
+  };
+  const SynthesizerConfig cfg;
+  emit("{\n  \"schema\": 1,\n");
+#ifdef NDEBUG
+  emit("  \"build\": \"release\",\n");
+#else
+  emit("  \"build\": \"debug\",\n");
+#endif
+  emit("  \"simd\": \"%s\",\n  \"sampleRate\": %d,\n",
+       kernels::simdLevelName(kernels::detectSimdLevel()), cfg.sampleRate);
+  emit("  \"fillSamples\": [\n");
+  for (size_t i = 0; i < synth.size(); ++i) {
+    const SynthResult &r = synth[i];
+    emit("    {\"voices\": %d, \"bufferFrames\": %d, \"voice\": \"%s\", "
+         "\"noise\": \"%s\", \"nsPerFrame\": %.3f, \"realtimeFactor\": %.2f}%s\n",
+         r.voices, r.bufferFrames, r.isochronic ? "isochronic" : "binaural",
+         noiseName(r.noise), r.nsPerFrame, r.realtimeFactor,
+         i + 1 < synth.size() ? "," : "");
+  }
+  emit("  ],\n  \"parseGnaural\": [\n");
+  for (size_t i = 0; i < parse.size(); ++i) {
+    const ParseResult &r = parse[i];
+    emit("    {\"preset\": \"%s\", \"entries\": %zu, \"bytes\": %zu, "
+         "\"usPerParse\": %.2f}%s\n",
+         r.name, r.entries, r.bytes, r.usPerParse,
+         i + 1 < parse.size() ? "," : "");
+  }
+  emit("  ],\n  \"waveformBuffer\": {\"pushNs\": %.2f, "
+       "\"pushBlockNs\": %.3f, \"pushNsContended\": %.2f, "
+       "\"worstBufferUs\": %.2f, \"getSamplesUs\": %.2f, \"reads\": %zu, "
+       "\"tornReads\": %zu},\n",
+       wave.pushNsIdle, wave.pushBlockNs, wave.pushNsContended,
+       wave.worstBufferUs, wave.getSamplesUs, wave.reads, wave.tornReads);
+  emit("  \"lockFreeQueue\": {\"pushPopNs\": %.3f, \"pushMItemsPerSec\": %.2f, "
+       "\"pushed\": %zu, \"popped\": %zu}\n}\n",
+       queue.pushPopNs, queue.mItemsPerSec, queue.pushed, queue.popped);
+  return static_cast<bool>(out);
+}
+
+int runSuite(const std::string &jsonPath) {
+  std::printf("Benchmark suite (detected: %s)\n",
+              kernels::simdLevelName(kernels::detectSimdLevel()));
+  const auto synth = suiteSynth();
+  const auto parse = suiteParse();
+  const WaveformResult wave = suiteWaveform();
+  const QueueResult queue = suiteQueue();
+  if (jsonPath.empty())
+    return 0;
+  if (!writeSuiteJson(jsonPath, synth, parse, wave, queue)) {
+    std::fprintf(stderr, "Error: cannot write %s\n", jsonPath.c_str());
+    return 1;
+  }
+  std::printf("\nWrote %s\n", jsonPath.c_str());
+  return 0;
+}
+
+// ---- 金标准回归（--golden）：确定性地渲染一组规范 program，与仓库中
+// 记录的频谱和校验和对比，并可与本机的耗时基线对比 ----
+//
+// 频谱是各声道半倍频程频带的平均功率 (dB)，对 SIMD 级别、编译器造成的
+// 最低位差异不敏感，是判定依据；校验和（输出样本的 FNV-1a）只在 --strict
+// 时要求一致，用来确认"逐位未变"的重构
+
+constexpr int GOLDEN_FFT = 4096;
+constexpr int GOLDEN_BANDS = 20;        // 20 Hz 起的半倍频程
+constexpr double GOLDEN_TOL_DB = 0.5;   // 频带允许的偏差
+// 低于此电平的频带不比较。电平为未归一化 FFT 功率，满幅正弦约 +63 dB，
+// int16 量化噪声每频带约 -45 dB；0.01 音量的背景噪声在 -25 dB 以上
+constexpr double GOLDEN_FLOOR_DB = -30.0;
+constexpr double DEFAULT_MAX_SLOWDOWN = 1.25;
+
+struct GoldenCase {
+  const char *name;
+  Program program;
+};
+
+struct GoldenRecord {
+  std::string name;
+  uint64_t frames = 0;
+  uint64_t checksum = 0;
+  double bands[2][GOLDEN_BANDS] = {};
+  double nsPerFrame = 0;
+};
+
+Program cliProgram(bool isochronic, Period::Background noise) {
+  // 与 BinauralBeats 的命令行默认值一致（--noise 时噪声音量默认 0.01）
+  Program program;
+  program.name = "CLI";
+  program.seq.push_back({
+      .lengthSec = 10.0,
+      .voices = {{.freqStart = 4.f,
+                  .freqEnd = 4.f,
+                  .volume = 0.7f,
+                  .pitch = 161.f,
+                  .isochronic = isochronic}},
+      .background = noise,
+      .backgroundVol = noise != Period::Background::None ? 0.01f : 0.f,
+  });
+  return program;
+}
+
+std::vector<GoldenCase> goldenCases() {
+  const char *txt = "# golden preset\n"
+                    "[BASEFREQ=180]\n"
+                    "[NOISEVOL=20]\n"
+                    "[TONEVOL=70]\n"
+                    "190, 180, 6\n"
+                    "187, 180, 5\n"
+                    "184, 180, 8\n"
+                    "182.5, 180, 4\n";
+  const char *xml =
+      "<?xml version=\"1.0\"?>\n<gnaural>\n<noisevol>15</noisevol>\n"
+      "<entry parent=\"0\" duration=\"4.5\" volume_left=\"0.80\" "
+      "volume_right=\"0.70\" beatfreq=\"10.00\" basefreq=\"200.0\" "
+      "state=\"1\"/>\n"
+      "<entry parent=\"0\" duration=\"0.75\" volume_left=\"0.60\" "
+      "volume_right=\"0.60\" beatfreq=\"7.50\" basefreq=\"150.0\" "
+      "state=\"1\"/>\n"
+      "<entry parent=\"0\" duration=\"3\" volume_left=\"0.40\" "
+      "volume_right=\"0.40\" beatfreq=\"0\" basefreq=\"0\" state=\"1\"/>\n"
+      "<entry parent=\"0\" duration=\"6.25\" volume_left=\"0.90\" "
+      "volume_right=\"0.85\" beatfreq=\"3.30\" basefreq=\"110.0\" "
+      "state=\"1\"/>\n"
+      "</gnaural>\n";
+  std::vector<GoldenCase> cases;
+  cases.push_back({"cli", cliProgram(false, Period::Background::None)});
+  cases.push_back({"isochronic", cliProgram(true, Period::Background::None)});
+  cases.push_back({"pink", cliProgram(false, Period::Background::PinkNoise)});
+  cases.push_back({"white", cliProgram(false, Period::Background::WhiteNoise)});
+  for (const auto &[name, text] : {std::pair{"gnaural-txt", txt},
+                                   std::pair{"gnaural-xml", xml}}) {
+    auto program = parseGnauralFromString(text);
+    cases.push_back({name, program ? *program : Program{}});
+  }
+  return cases;
+}
+
+// 原地基 2 FFT，n 为 2 的幂
+void fft(std::vector<std::complex<double>> &x) {
+  const size_t n = x.size();
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j)
+      std::swap(x[i], x[j]);
+  }
+  for (size_t len = 2; len <= n; len <<= 1) {
+    const double a = -2.0 * 3.14159265358979323846 / static_cast<double>(len);
+    const std::complex<double> w(std::cos(a), std::sin(a));
+    for (size_t i = 0; i < n; i += len) {
+      std::complex<double> wk(1.0, 0.0);
+      for (size_t k = 0; k < len / 2; ++k) {
+        const std::complex<double> u = x[i + k];
+        const std::complex<double> v = x[i + k + len / 2] * wk;
+        x[i + k] = u + v;
+        x[i + k + len / 2] = u - v;
+        wk *= w;
+      }
+    }
+  }
+}
+
+// Hann 窗、不重叠分帧的平均功率谱，按半倍频程求和后取 dB
+void bandLevels(const std::vector<int16_t> &samples, int channel,
+                int sampleRate, double *out) {
+  std::vector<double> power(GOLDEN_FFT / 2, 0.0);
+  std::vector<std::complex<double>> frame(GOLDEN_FFT);
+  const size_t frames = samples.size() / 2;
+  size_t windows = 0;
+  for (size_t start = 0; start + GOLDEN_FFT <= frames; start += GOLDEN_FFT) {
+    for (int i = 0; i < GOLDEN_FFT; ++i) {
+      const double w =
+          0.5 - 0.5 * std::cos(2.0 * 3.14159265358979323846 * i / GOLDEN_FFT);
+      frame[i] = w * samples[(start + i) * 2 + channel] / 32768.0;
+    }
+    fft(frame);
+    for (int k = 0; k < GOLDEN_FFT / 2; ++k)
+      power[k] += std::norm(frame[k]);
+    ++windows;
+  }
+  const double binHz = static_cast<double>(sampleRate) / GOLDEN_FFT;
+  for (int b = 0; b < GOLDEN_BANDS; ++b) {
+    const double lo = 20.0 * std::pow(2.0, b * 0.5);
+    const double hi = lo * std::sqrt(2.0);
+    double sum = 0.0;
+    for (int k = 1; k < GOLDEN_FFT / 2; ++k) {
+      const double hz = k * binHz;
+      if (hz >= lo && hz < hi)
+        sum += power[k];
+    }
+    // -200 dB 表示频带内没有能量
+    out[b] = sum > 0.0 && windows > 0
+                 ? 10.0 * std::log10(sum / static_cast<double>(windows))
+                 : -200.0;
+  }
+}
+
+// 与实时回调相同的 fillSamples + advanceFrames，渲染整个 program；
+// 耗时取 SUITE_REPEATS 次中最快的
+GoldenRecord renderGolden(const GoldenCase &c) {
+  const SynthesizerConfig cfg;
+  GoldenRecord r;
+  r.name = c.name;
+  uint64_t total = 0;
+  for (const Period &period : c.program.seq)
+    total += static_cast<uint64_t>(periodFrames(period, cfg.sampleRate));
+  const size_t bufferFrames = static_cast<size_t>(cfg.bufferFrames);
+  const size_t buffers = (total + bufferFrames - 1) / bufferFrames;
+  std::vector<int16_t> out(buffers * bufferFrames * 2);
+  double best = 1e300;
+  for (int rep = 0; rep < SUITE_REPEATS; ++rep) {
+    Synthesizer synth(cfg);
+    synth.setProgram(c.program);
+    std::vector<int16_t> buf;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < buffers; ++b) {
+      synth.fillSamples(buf);
+      synth.advanceFrames(bufferFrames);
+      std::copy(buf.begin(), buf.end(), out.begin() + b * bufferFrames * 2);
+    }
+    best = std::min(best, std::chrono::duration<double, std::nano>(
+                              std::chrono::steady_clock::now() - t0)
+                              .count());
+  }
+  out.resize(total * 2);
+  r.frames = total;
+  r.checksum = RenderCache::fnv1a(std::string(
+      reinterpret_cast<const char *>(out.data()), out.size() * sizeof(int16_t)));
+  for (int ch = 0; ch < 2; ++ch)
+    bandLevels(out, ch, cfg.sampleRate, r.bands[ch]);
+  r.nsPerFrame = total ? best / static_cast<double>(buffers * bufferFrames) : 0;
+  return r;
+}
+
+// 金标准文件：每个 program 一行，名称、帧数、校验和（16 进制），随后是
+// 左、右声道各 GOLDEN_BANDS 个频带电平 (dB)。# 开头为注释
+std::vector<GoldenRecord> readGolden(const std::string &path) {
+  std::vector<GoldenRecord> records;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    GoldenRecord r;
+    fields >> r.name >> r.frames >> std::hex >> r.checksum >> std::dec;
+    for (auto &channel : r.bands)
+      for (double &level : channel)
+        fields >> level;
+    if (fields)
+      records.push_back(r);
+  }
+  return records;
+}
+
+bool writeGolden(const std::string &path,
+                 const std::vector<GoldenRecord> &records) {
+  std::ofstream out(path);
+  out << "# BinauralBench --golden: name frames fnv1a64 then "
+      << GOLDEN_BANDS << " half-octave band levels (dB from 20 Hz) for L, R\n"
+      << "# Regenerate with: BinauralBench --golden --update\n";
+  char buf[32];
+  for (const GoldenRecord &r : records) {
+    std::snprintf(buf, sizeof(buf), "%016llx",
+                  static_cast<unsigned long long>(r.checksum));
+    out << r.name << ' ' << r.frames << ' ' << buf;
+    for (const auto &channel : r.bands)
+      for (double level : channel) {
+        std::snprintf(buf, sizeof(buf), " %.2f", level);
+        out << buf;
+      }
+    out << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+// 耗时基线：每行 name ns/frame，与机器相关，不入库
+std::vector<std::pair<std::string, double>>
+readBaseline(const std::string &path) {
+  std::vector<std::pair<std::string, double>> baseline;
+  std::ifstream in(path);
+  std::string name;
+  double ns = 0;
+  while (in >> name >> ns)
+    baseline.emplace_back(name, ns);
+  return baseline;
+}
+
+// 与金标准对比的最大频带偏差 (dB)，只比较任一方高于 GOLDEN_FLOOR_DB 的频带
+double maxBandDiff(const GoldenRecord &a, const GoldenRecord &b) {
+  double diff = 0.0;
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int k = 0; k < GOLDEN_BANDS; ++k) {
+      if (std::max(a.bands[ch][k], b.bands[ch][k]) < GOLDEN_FLOOR_DB)
+        continue;
+      diff = std::max(diff, std::abs(a.bands[ch][k] - b.bands[ch][k]));
+    }
+  }
+  return diff;
+}
+
+struct GoldenOptions {
+  std::string goldenPath;
+  std::string baselinePath;
+  double maxSlowdown = DEFAULT_MAX_SLOWDOWN;
+  bool update = false;
+  bool strict = false;
+};
+
+int runGolden(const GoldenOptions &opt) {
+  std::vector<GoldenRecord> current;
+  for (const GoldenCase &c : goldenCases())
+    current.push_back(renderGolden(c));
+
+  if (opt.update) {
+    if (!writeGolden(opt.goldenPath, current)) {
+      std::fprintf(stderr, "Error: cannot write %s\n", opt.goldenPath.c_str());
+      return 1;
+    }
+    std::printf("Wrote %s\n", opt.goldenPath.c_str());
+    if (!opt.baselinePath.empty()) {
+      std::ofstream out(opt.baselinePath);
+      for (const GoldenRecord &r : current)
+        out << r.name << ' ' << r.nsPerFrame << '\n';
+      std::printf("Wrote %s\n", opt.baselinePath.c_str());
+    }
+    return 0;
+  }
+
+  const auto golden = readGolden(opt.goldenPath);
+  const auto baseline = opt.baselinePath.empty()
+                            ? std::vector<std::pair<std::string, double>>{}
+                            : readBaseline(opt.baselinePath);
+  if (golden.empty()) {
+    std::fprintf(stderr, "Error: no golden records in %s\n",
+                 opt.goldenPath.c_str());
+    return 1;
+  }
+  bool ok = true;
+  std::printf("Golden output (%s; band tolerance %.1f dB",
+              opt.goldenPath.c_str(), GOLDEN_TOL_DB);
+  if (!baseline.empty())
+    std::printf(", max slowdown %.2fx", opt.maxSlowdown);
+  std::printf(")\n%-12s %10s %10s %10s %10s %10s  %s\n", "program", "frames",
+              "band dB", "checksum", "ns/frame", "slowdown", "result");
+  for (const GoldenRecord &r : current) {
+    const auto g = std::find_if(golden.begin(), golden.end(),
+                                [&](const GoldenRecord &x) {
+                                  return x.name == r.name;
+                                });
+    if (g == golden.end()) {
+      std::printf("%-12s %10llu %10s %10s %10.2f %10s  MISSING\n",
+                  r.name.c_str(), static_cast<unsigned long long>(r.frames),
+                  "-", "-", r.nsPerFrame, "-");
+      ok = false;
+      continue;
+    }
+    const double diff = maxBandDiff(r, *g);
+    const bool same = r.checksum == g->checksum;
+    double slowdown = 0.0;
+    for (const auto &[name, ns] : baseline)
+      if (name == r.name && ns > 0)
+        slowdown = r.nsPerFrame / ns;
+    const bool pass = r.frames == g->frames && diff <= GOLDEN_TOL_DB &&
+                      (same || !opt.strict) &&
+                      (slowdown == 0.0 || slowdown <= opt.maxSlowdown);
+    char slowBuf[16] = "-";
+    if (slowdown > 0.0)
+      std::snprintf(slowBuf, sizeof(slowBuf), "%.2fx", slowdown);
+    std::printf("%-12s %10llu %10.3f %10s %10.2f %10s  %s\n", r.name.c_str(),
+                static_cast<unsigned long long>(r.frames), diff,
+                same ? "same" : "changed", r.nsPerFrame, slowBuf,
+                pass ? "OK" : "FAILED");
+    ok = ok && pass;
+  }
+  std::printf("Golden output: %s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  bool suite = false;
+  bool golden = false;
+  std::string jsonPath;
+  GoldenOptions goldenOpt;
+  goldenOpt.goldenPath = BINAURAL_GOLDEN_FILE;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc && std::strncmp(argv[i + 1], "--", 2);
+    if (arg == "--suite") {
+      suite = true;
+    } else if (arg == "--json" && hasValue) {
+      jsonPath = argv[++i];
+    } else if (arg == "--golden") {
+      golden = true;
+      if (hasValue)
+        goldenOpt.goldenPath = argv[++i];
+    } else if (arg == "--update") {
+      goldenOpt.update = true;
+    } else if (arg == "--strict") {
+      goldenOpt.strict = true;
+    } else if (arg == "--baseline" && hasValue) {
+      goldenOpt.baselinePath = argv[++i];
+    } else if (arg == "--max-slowdown" && hasValue &&
+               std::strtod(argv[i + 1], nullptr) >= 1.0) {
+      goldenOpt.maxSlowdown = std::strtod(argv[++i], nullptr);
+    } else {
+      std::fprintf(
+          stderr,
+          "Usage: %s [--suite [--json PATH]] [--golden [FILE] [options]]\n"
+          "  (no options)        kernel benchmarks and correctness checks\n"
+          "  --suite             performance suite only\n"
+          "  --json PATH         write suite results as JSON\n"
+          "  --golden [FILE]     compare canonical renders with FILE\n"
+          "                      (default: %s)\n"
+          "  --update            rewrite the golden file (and baseline)\n"
+          "  --strict            also require identical checksums\n"
+          "  --baseline PATH     compare render time with a stored baseline\n"
+          "  --max-slowdown R    allowed time ratio vs baseline (default: "
+          "%.2f)\n",
+          argv[0], BINAURAL_GOLDEN_FILE, DEFAULT_MAX_SLOWDOWN);
+      return 2;
+    }
+  }
+  if (golden)
+    return runGolden(goldenOpt);
+  if (suite || !jsonPath.empty())
+    return runSuite(jsonPath);
+
+  const auto cases = makeCases(BENCH_VOICES);
+  std::vector<SimdLevel> levels{SimdLevel::Scalar};
+  for (SimdLevel l : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Neon}) {
+    const SimdLevel resolved = kernels::resolveSimdLevel(l);
+    if (std::find(levels.begin(), levels.end(), resolved) == levels.end())
+      levels.push_back(resolved);
+  }
+
+  std::printf("Oscillator kernels, reference tier (%d voices x %d frames, "
+              "detected: %s)\n",
+              BENCH_VOICES, BENCH_FRAMES,
+              kernels::simdLevelName(kernels::detectSimdLevel()));
+  std::printf("%-8s %-11s %14s %12s %12s\n", "level", "voice", "ns/voice-frame",
+              "speedup", "max err");
+
+  bool ok = true;
+  for (bool iso : {false, true}) {
+    const double libmNs = nsPerVoiceFrame(LIBM_KERNELS, iso, cases);
+    std::printf("%-8s %-11s %14.3f %11.2fx %12.3g\n", "libm",
+                iso ? "isochronic" : "binaural", libmNs, 1.0, 0.0);
+    for (SimdLevel l : levels) {
+      const auto &k = kernels::selectKernels(l);
+      const double ns = nsPerVoiceFrame(k, iso, cases);
+      const float err = maxErrorVsLibm(k, iso, cases);
+      if (err > kernels::MAX_VECTOR_ERROR)
+        ok = false;
+      std::printf("%-8s %-11s %14.3f %11.2fx %12.3g\n",
+                  kernels::simdLevelName(l), iso ? "isochronic" : "binaural",
+                  ns, libmNs / ns, err);
+    }
+  }
+  std::printf("Error bound %.1g: %s\n", kernels::MAX_VECTOR_ERROR,
+              ok ? "OK" : "EXCEEDED");
+
+  if (!benchQualityTiers(cases))
+    ok = false;
+  if (!benchOscillatorBackends())
+    ok = false;
+  if (!benchMixPaths())
+    ok = false;
+  if (!benchFrequencySweep())
+    ok = false;
+  if (!benchPeriodBoundaries())
+    ok = false;
+  if (!benchSoak())
+    ok = false;
+  if (!benchParamSmoothing())
+    ok = false;
+  if (!benchProgramExchange())
+    ok = false;
+  if (!benchOfflineRender())
+    ok = false;
+  if (!benchAudioStats())
+    ok = false;
+  if (!benchTrace())
+    ok = false;
+  if (!benchWaveformBuffer())
+    ok = false;
+  if (!benchWaveformPyramid())
+    ok = false;
+  return ok ? 0 : 1;
+}
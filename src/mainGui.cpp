@@ -5,9 +5,10 @@
 #include "binaural/audioDriver.hpp"
 #include "binaural/parameterController.hpp"
 #include "binaural/period.hpp"
+#include "binaural/programExchange.hpp"
 #include "binaural/synthesizer.hpp"
 #include "binaural/wavDriver.hpp"
-#include "binaural/waveformBuffer.hpp"
+#include "binaural/waveformPyramid.hpp"
 #include "gui/guiFonts.hpp"
 #include "gui/guiPanels.hpp"
 #include "gui/guiUtils.hpp"
@@ -46,18 +47,20 @@ int main() {
 
   Synthesizer synth(config);
   synth.setProgram(program);
+  ProgramExchange programs(synth);
 
   ParameterController::PredictionQueue predQueue;
   ParameterController paramController(synth, predQueue);
 
-  WaveformBuffer waveBuf(2048);
+  WaveformPyramid wavePeaks;
 
   gui::AppContext ctx{
       .program = program,
       .synth = synth,
+      .programs = programs,
       .paramController = paramController,
       .predQueue = predQueue,
-      .waveBuf = waveBuf,
+      .wavePeaks = wavePeaks,
       .config = config,
       .driver = nullptr,
       .beatFreq = 4.f,
@@ -68,7 +71,7 @@ int main() {
       .showLoadModal = false,
       .showHelpCenter = false,
       .loadedFromGnaural = false,
-      .manualElapsedSec = 0.f,
+      .manualElapsedFrames = 0,
       .timedPlaybackEnabled = false,
       .timedPlaybackDurationSec = 600.f,
       .showTimedPlaybackModal = false,
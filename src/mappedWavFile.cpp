@@ -0,0 +1,137 @@
+#include "binaural/mappedWavFile.hpp"
+#include "binaural/wavWriter.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace binaural {
+
+MappedWavFile::~MappedWavFile() {
+    if (isOpen()) close();
+}
+
+int16_t* MappedWavFile::samples() const {
+    // 头部 80 字节，样本区保持 2 字节对齐
+    return data_ ? reinterpret_cast<int16_t*>(data_ + WAV_HEADER_SIZE)
+                 : nullptr;
+}
+
+#ifdef _WIN32
+
+bool MappedWavFile::create(const std::string& path, int sampleRate,
+                           uint64_t frames, int channels) {
+    if (isOpen()) close();
+    if (frames == 0) return false;
+    const uint64_t size =
+        WAV_HEADER_SIZE +
+        frames * static_cast<uint64_t>(channels) * sizeof(int16_t);
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+                              nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    file_ = file;
+    // 以映射长度创建映射对象时文件随之扩展到 size
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(size >> 32),
+                                  static_cast<DWORD>(size), nullptr);
+    if (mapping_) {
+        data_ = static_cast<char*>(
+            MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, 0));
+    }
+    if (!data_) {
+        release();
+        DeleteFileA(path.c_str());
+        return false;
+    }
+    size_ = size;
+    frames_ = frames;
+    makeWavHeader(data_, sampleRate, channels, frames);
+    return true;
+}
+
+bool MappedWavFile::close() {
+    if (!isOpen()) return false;
+    const bool ok = UnmapViewOfFile(data_) != 0;
+    data_ = nullptr;
+    release();
+    return ok;
+}
+
+void MappedWavFile::release() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+    size_ = 0;
+    frames_ = 0;
+}
+
+#else
+
+bool MappedWavFile::create(const std::string& path, int sampleRate,
+                           uint64_t frames, int channels) {
+    if (isOpen()) close();
+    if (frames == 0) return false;
+    const uint64_t size =
+        WAV_HEADER_SIZE +
+        frames * static_cast<uint64_t>(channels) * sizeof(int16_t);
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+    // 预先分配磁盘块：空间不足在此失败，而不是写映射区时收到 SIGBUS
+#ifdef __APPLE__
+    const bool allocated = ::ftruncate(fd_, static_cast<off_t>(size)) == 0;
+#else
+    const bool allocated =
+        ::posix_fallocate(fd_, 0, static_cast<off_t>(size)) == 0;
+#endif
+    if (allocated) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd_, 0);
+        if (p != MAP_FAILED) data_ = static_cast<char*>(p);
+    }
+    if (!data_) {
+        release();
+        ::unlink(path.c_str());
+        return false;
+    }
+    size_ = size;
+    frames_ = frames;
+    // 顺序写入为主，提示内核提前回写
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+    makeWavHeader(data_, sampleRate, channels, frames);
+    return true;
+}
+
+bool MappedWavFile::close() {
+    if (!isOpen()) return false;
+    // 不做 msync：munmap 后脏页仍由内核回写，与普通 write 的持久性相同
+    const bool ok = ::munmap(data_, size_) == 0;
+    data_ = nullptr;
+    release();
+    return ok;
+}
+
+void MappedWavFile::release() {
+    if (data_) ::munmap(data_, size_);
+    if (fd_ >= 0) ::close(fd_);
+    data_ = nullptr;
+    fd_ = -1;
+    size_ = 0;
+    frames_ = 0;
+}
+
+#endif
+
+}  // namespace binaural
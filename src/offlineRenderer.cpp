@@ -0,0 +1,175 @@
+#include "binaural/offlineRenderer.hpp"
+#include "binaural/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace binaural {
+
+namespace {
+// 每线程的块数，块数多于线程数以平衡各 period 的负载差异
+constexpr uint64_t CHUNKS_PER_THREAD = 4;
+// 块太小时建立时间线与粉红噪声定位的开销占比过高
+constexpr uint64_t MIN_CHUNK_BUFFERS = 32;
+}  // namespace
+
+OfflineRenderer::OfflineRenderer(const Program& program,
+                                 const SynthesizerConfig& config)
+    : program_(program), config_(config) {
+    for (const auto& period : program_.seq) {
+        totalFrames_ +=
+            static_cast<uint64_t>(periodFrames(period, config_.sampleRate));
+    }
+    const uint64_t bufferFrames = static_cast<uint64_t>(config_.bufferFrames);
+    totalBuffers_ = (totalFrames_ + bufferFrames - 1) / bufferFrames;
+}
+
+std::vector<int16_t> OfflineRenderer::render(int threads) const {
+    std::vector<int16_t> out(totalFrames() * 2);
+    render(out.data(), threads);
+    return out;
+}
+
+void OfflineRenderer::renderSerial(int16_t* out) const {
+    renderFrames(0, totalFrames_, out);
+}
+
+void OfflineRenderer::render(int16_t* out, int threads) const {
+    CacheSession session;
+    renderCached(0, totalFrames_, out, threads, session);
+}
+
+void OfflineRenderer::setCache(RenderCache* cache) {
+    cache_ = cache;
+    segments_.clear();
+    if (!cache_) return;
+    Synthesizer synth(config_);
+    synth.setProgram(program_);
+    for (size_t p = 0; p < program_.seq.size(); ++p) {
+        const Synthesizer::Segment seg = synth.segment(static_cast<int>(p));
+        const uint64_t first = seg.begin;
+        const uint64_t end = std::min(seg.end, totalFrames_);
+        if (end > first) {
+            segments_.push_back(
+                {first, end - first, synth.segmentKey(static_cast<int>(p))});
+        }
+    }
+}
+
+void OfflineRenderer::renderCached(uint64_t first, uint64_t count,
+                                   int16_t* out, int threads,
+                                   CacheSession& session) const {
+    if (!cache_) {
+        renderRange(first, count, out, threads);
+        return;
+    }
+    const uint64_t last = first + count;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        const CachedSegment& seg = segments_[i];
+        const uint64_t b = std::max(first, seg.first);
+        const uint64_t e = std::min(last, seg.first + seg.count);
+        if (b >= e) continue;
+        int16_t* dst = out + (b - first) * 2;
+        const uint64_t frames = e - b;
+        if (session.segment != i &&
+            cache_->read(seg.key, b - seg.first, dst,
+                         static_cast<size_t>(frames)))
+            continue;
+
+        renderRange(b, frames, dst, threads);
+        // 从区间起点顺序渲染到区间末尾时才形成完整条目
+        if (b == seg.first) {
+            session.writer = cache_->beginWrite(seg.key, seg.count);
+            session.segment = i;
+        }
+        if (session.segment == i &&
+            session.writer.append(dst, static_cast<size_t>(frames)) &&
+            session.writer.remaining() == 0) {
+            session.writer.commit();
+            session.segment = SIZE_MAX;
+        }
+    }
+}
+
+bool OfflineRenderer::render(const Sink& sink, int threads,
+                             ExportStats* stats) const {
+    const uint64_t windowFrames =
+        std::min(WINDOW_BUFFERS, std::max<uint64_t>(totalBuffers_, 1)) *
+        static_cast<uint64_t>(config_.bufferFrames);
+    WritePipeline pipeline(static_cast<size_t>(windowFrames));
+    uint64_t next = 0;
+    CacheSession session;
+    const bool ok = pipeline.run(
+        [&](int16_t* out, size_t) -> size_t {
+            if (next >= totalFrames_) return 0;
+            const uint64_t count = std::min(windowFrames, totalFrames_ - next);
+            renderCached(next, count, out, threads, session);
+            next += count;
+            return static_cast<size_t>(count);
+        },
+        sink);
+    if (stats) *stats = pipeline.stats();
+    return ok;
+}
+
+void OfflineRenderer::renderRange(uint64_t first, uint64_t count,
+                                  int16_t* out, int threads) const {
+    if (threads <= 0) {
+        threads = static_cast<int>(
+            std::max(1u, std::thread::hardware_concurrency()));
+    }
+    const uint64_t bufferFrames = static_cast<uint64_t>(config_.bufferFrames);
+    const uint64_t numBuffers = (count + bufferFrames - 1) / bufferFrames;
+    const uint64_t numChunks = std::max<uint64_t>(
+        1, std::min(static_cast<uint64_t>(threads) * CHUNKS_PER_THREAD,
+                    numBuffers / MIN_CHUNK_BUFFERS));
+    if (threads == 1 || numChunks == 1) {
+        renderFrames(first, count, out);
+        return;
+    }
+
+    const uint64_t chunkFrames =
+        (numBuffers + numChunks - 1) / numChunks * bufferFrames;
+    std::atomic<uint64_t> nextChunk{0};
+    auto worker = [&]() {
+        for (;;) {
+            const uint64_t c = nextChunk.fetch_add(1);
+            const uint64_t offset = c * chunkFrames;
+            if (offset >= count) break;
+            renderFrames(first + offset, std::min(chunkFrames, count - offset),
+                         out + offset * 2);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    const int numWorkers =
+        static_cast<int>(std::min<uint64_t>(threads, numChunks)) - 1;
+    for (int t = 0; t < numWorkers; ++t) {
+        pool.emplace_back([&worker] {
+            worker();
+            trace::releaseThread();
+        });
+    }
+    worker();
+    for (auto& t : pool) t.join();
+}
+
+void OfflineRenderer::renderFrames(uint64_t first, uint64_t count,
+                                   int16_t* out) const {
+    Synthesizer synth(config_);
+    synth.setProgram(program_);
+    const uint64_t bufferFrames = static_cast<uint64_t>(config_.bufferFrames);
+
+    // 每 buffer 的控制流程与实时回调相同：渲染 -> advanceFrames。
+    // 区间不从 buffer 边界开始时先补齐到边界，渲染在哪里切分不影响输出
+    synth.seekProgram(first);
+    for (uint64_t f = 0; f < count;) {
+        const uint64_t n =
+            std::min(bufferFrames - (first + f) % bufferFrames, count - f);
+        synth.render(out + f * 2, static_cast<size_t>(n));
+        synth.advanceFrames(n);
+        f += n;
+    }
+}
+
+}  // namespace binaural
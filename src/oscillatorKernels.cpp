@@ -0,0 +1,676 @@
+#include "binaural/oscillatorKernels.hpp"
+#include "binaural/sinTable.hpp"
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define BINAURAL_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define BINAURAL_HAS_AVX2 1
+#define BINAURAL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BINAURAL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace binaural {
+namespace kernels {
+
+namespace {
+constexpr float TWO_PI = 6.283185307f;
+
+// sin(πv) ≈ v(1 - v²)·Q(v²)，v ∈ [-1, 1]。Q 为加权 minimax 拟合，
+// 两端零点精确，无需象限折叠。各档 Q 的阶数与 double 求值误差：
+// Draft 2 阶 2.9e-4，Standard 3 阶 6.6e-6，Reference 5 阶 1.3e-9
+template <QualityTier Tier>
+struct SinPiPoly;
+
+template <>
+struct SinPiPoly<QualityTier::Draft> {
+    static constexpr int N = 3;
+    static constexpr float C[N] = {3.1390342623f, -1.9948684647f,
+                                   0.4337707972f};
+};
+
+template <>
+struct SinPiPoly<QualityTier::Standard> {
+    static constexpr int N = 4;
+    static constexpr float C[N] = {3.1415211395f, -2.0247730853f,
+                                   0.5174912341f, -0.0636897933f};
+};
+
+template <>
+struct SinPiPoly<QualityTier::Reference> {
+    static constexpr int N = 6;
+    static constexpr float C[N] = {3.1415926350f, -2.0261194553f,
+                                   0.5240371762f, -0.0751922213f,
+                                   0.0068679185f, -0.0003898144f};
+};
+
+template <QualityTier Tier>
+inline float sinPiPoly(float v) {
+    using P = SinPiPoly<Tier>;
+    const float w = v * v;
+    float q = P::C[P::N - 1];
+    for (int i = P::N - 2; i >= 0; --i) q = q * w + P::C[i];
+    return v * (1.0f - w) * q;
+}
+
+// phase 为任意实数（周期），返回 sin(2π·phase)
+template <QualityTier Tier>
+inline float sin2PiPoly(float phase) {
+    const float u = phase - std::floor(phase + 0.5f);
+    return sinPiPoly<Tier>(2.0f * u);
+}
+
+// 等时脉冲包络：phase ∈ [0, 0.5) 时 cos(π·phase)，否则 0
+template <QualityTier Tier>
+inline float isoGainPoly(float phase) {
+    const float p = phase - std::floor(phase);
+    return p < 0.5f ? sinPiPoly<Tier>(0.5f - p) : 0.0f;
+}
+
+// 第 k 帧的相位：phase + k·(inc + k·curve)，curve = 0 时与线性相位逐位一致
+inline float phaseAt(float phase, float inc, float curve, float kf) {
+    return phase + kf * (inc + kf * curve);
+}
+
+// ---- Scalar：逐帧多项式，同时作为向量内核的尾部帧 ----
+
+template <QualityTier Tier>
+void binauralTail(float* outL, float* outR, int begin, int numFrames,
+                  const Ramp& l, const Ramp& r, float vol) {
+    for (int k = begin; k < numFrames; ++k) {
+        const float kf = static_cast<float>(k);
+        outL[k] += sin2PiPoly<Tier>(phaseAt(l.start, l.inc, l.curve, kf)) * vol;
+        outR[k] += sin2PiPoly<Tier>(phaseAt(r.start, r.inc, r.curve, kf)) * vol;
+    }
+}
+
+template <QualityTier Tier>
+void isochronicTail(float* outL, float* outR, int begin, int numFrames,
+                    const Ramp& carrier, const Ramp& iso, float vol) {
+    for (int k = begin; k < numFrames; ++k) {
+        const float kf = static_cast<float>(k);
+        const float s =
+            sin2PiPoly<Tier>(
+                phaseAt(carrier.start, carrier.inc, carrier.curve, kf)) *
+            isoGainPoly<Tier>(phaseAt(iso.start, iso.inc, iso.curve, kf)) *
+            vol;
+        outL[k] += s;
+        outR[k] += s;
+    }
+}
+
+template <QualityTier Tier>
+void binauralScalar(float* outL, float* outR, int numFrames, const Ramp& l,
+                    const Ramp& r, float vol) {
+    binauralTail<Tier>(outL, outR, 0, numFrames, l, r, vol);
+}
+
+template <QualityTier Tier>
+void isochronicScalar(float* outL, float* outR, int numFrames,
+                      const Ramp& carrier, const Ramp& iso, float vol) {
+    isochronicTail<Tier>(outL, outR, 0, numFrames, carrier, iso, vol);
+}
+
+#if defined(BINAURAL_X86)
+
+// ---- SSE2：4 帧一组 ----
+
+inline __m128 roundSse2(__m128 x) {
+    // cvtps2dq 按 MXCSR 默认的就近舍入；相位远小于 2^31
+    return _mm_cvtepi32_ps(_mm_cvtps_epi32(x));
+}
+
+template <QualityTier Tier>
+inline __m128 sinPiSse2(__m128 v) {
+    using P = SinPiPoly<Tier>;
+    const __m128 w = _mm_mul_ps(v, v);
+    __m128 q = _mm_set1_ps(P::C[P::N - 1]);
+    for (int i = P::N - 2; i >= 0; --i)
+        q = _mm_add_ps(_mm_mul_ps(q, w), _mm_set1_ps(P::C[i]));
+    return _mm_mul_ps(_mm_mul_ps(v, _mm_sub_ps(_mm_set1_ps(1.0f), w)), q);
+}
+
+template <QualityTier Tier>
+inline __m128 sin2PiSse2(__m128 phase) {
+    const __m128 u = _mm_sub_ps(phase, roundSse2(phase));
+    return sinPiSse2<Tier>(_mm_add_ps(u, u));
+}
+
+template <QualityTier Tier>
+inline __m128 isoGainSse2(__m128 phase) {
+    __m128 fl = _mm_cvtepi32_ps(_mm_cvttps_epi32(phase));
+    fl = _mm_sub_ps(fl, _mm_and_ps(_mm_cmpgt_ps(fl, phase), _mm_set1_ps(1.0f)));
+    const __m128 p = _mm_sub_ps(phase, fl);
+    const __m128 mask = _mm_cmplt_ps(p, _mm_set1_ps(0.5f));
+    return _mm_and_ps(mask,
+                      sinPiSse2<Tier>(_mm_sub_ps(_mm_set1_ps(0.5f), p)));
+}
+
+// 与 phaseAt 相同的求值顺序
+struct RampSse2 {
+    __m128 start, inc, curve;
+    explicit RampSse2(const Ramp& r)
+        : start(_mm_set1_ps(r.start)),
+          inc(_mm_set1_ps(r.inc)),
+          curve(_mm_set1_ps(r.curve)) {}
+    __m128 at(__m128 kf) const {
+        return _mm_add_ps(
+            start, _mm_mul_ps(kf, _mm_add_ps(inc, _mm_mul_ps(kf, curve))));
+    }
+};
+
+template <QualityTier Tier>
+void binauralSse2(float* outL, float* outR, int numFrames, const Ramp& l,
+                  const Ramp& r, float vol) {
+    const __m128 lane = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+    const RampSse2 vL(l);
+    const RampSse2 vR(r);
+    const __m128 vVol = _mm_set1_ps(vol);
+    int k = 0;
+    for (; k + 4 <= numFrames; k += 4) {
+        const __m128 kf = _mm_add_ps(_mm_set1_ps(static_cast<float>(k)), lane);
+        const __m128 sL = sin2PiSse2<Tier>(vL.at(kf));
+        const __m128 sR = sin2PiSse2<Tier>(vR.at(kf));
+        _mm_storeu_ps(outL + k,
+                      _mm_add_ps(_mm_loadu_ps(outL + k), _mm_mul_ps(sL, vVol)));
+        _mm_storeu_ps(outR + k,
+                      _mm_add_ps(_mm_loadu_ps(outR + k), _mm_mul_ps(sR, vVol)));
+    }
+    binauralTail<Tier>(outL, outR, k, numFrames, l, r, vol);
+}
+
+template <QualityTier Tier>
+void isochronicSse2(float* outL, float* outR, int numFrames,
+                    const Ramp& carrier, const Ramp& iso, float vol) {
+    const __m128 lane = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+    const RampSse2 vC(carrier);
+    const RampSse2 vI(iso);
+    const __m128 vVol = _mm_set1_ps(vol);
+    int k = 0;
+    for (; k + 4 <= numFrames; k += 4) {
+        const __m128 kf = _mm_add_ps(_mm_set1_ps(static_cast<float>(k)), lane);
+        const __m128 c = sin2PiSse2<Tier>(vC.at(kf));
+        const __m128 g = isoGainSse2<Tier>(vI.at(kf));
+        const __m128 s = _mm_mul_ps(_mm_mul_ps(c, g), vVol);
+        _mm_storeu_ps(outL + k, _mm_add_ps(_mm_loadu_ps(outL + k), s));
+        _mm_storeu_ps(outR + k, _mm_add_ps(_mm_loadu_ps(outR + k), s));
+    }
+    isochronicTail<Tier>(outL, outR, k, numFrames, carrier, iso, vol);
+}
+
+#if defined(BINAURAL_HAS_AVX2)
+
+// ---- AVX2 + FMA：8 帧一组 ----
+
+template <QualityTier Tier>
+BINAURAL_TARGET_AVX2 inline __m256 sinPiAvx2(__m256 v) {
+    using P = SinPiPoly<Tier>;
+    const __m256 w = _mm256_mul_ps(v, v);
+    __m256 q = _mm256_set1_ps(P::C[P::N - 1]);
+    for (int i = P::N - 2; i >= 0; --i)
+        q = _mm256_fmadd_ps(q, w, _mm256_set1_ps(P::C[i]));
+    return _mm256_mul_ps(_mm256_fnmadd_ps(v, w, v), q);
+}
+
+template <QualityTier Tier>
+BINAURAL_TARGET_AVX2 inline __m256 sin2PiAvx2(__m256 phase) {
+    const __m256 u = _mm256_sub_ps(
+        phase, _mm256_round_ps(phase, _MM_FROUND_TO_NEAREST_INT |
+                                          _MM_FROUND_NO_EXC));
+    return sinPiAvx2<Tier>(_mm256_add_ps(u, u));
+}
+
+template <QualityTier Tier>
+BINAURAL_TARGET_AVX2 inline __m256 isoGainAvx2(__m256 phase) {
+    const __m256 p = _mm256_sub_ps(phase, _mm256_floor_ps(phase));
+    const __m256 mask = _mm256_cmp_ps(p, _mm256_set1_ps(0.5f), _CMP_LT_OQ);
+    return _mm256_and_ps(
+        mask, sinPiAvx2<Tier>(_mm256_sub_ps(_mm256_set1_ps(0.5f), p)));
+}
+
+// 相位 start + kf·(inc + kf·curve)，两次 FMA；curve = 0 时与线性相位一致
+struct RampAvx2 {
+    __m256 start, inc, curve;
+    BINAURAL_TARGET_AVX2 explicit RampAvx2(const Ramp& r)
+        : start(_mm256_set1_ps(r.start)),
+          inc(_mm256_set1_ps(r.inc)),
+          curve(_mm256_set1_ps(r.curve)) {}
+    BINAURAL_TARGET_AVX2 __m256 at(__m256 kf) const {
+        return _mm256_fmadd_ps(kf, _mm256_fmadd_ps(kf, curve, inc), start);
+    }
+};
+
+template <QualityTier Tier>
+BINAURAL_TARGET_AVX2 void binauralAvx2(float* outL, float* outR,
+                                       int numFrames, const Ramp& l,
+                                       const Ramp& r, float vol) {
+    const __m256 lane = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+    const RampAvx2 vL(l);
+    const RampAvx2 vR(r);
+    const __m256 vVol = _mm256_set1_ps(vol);
+    int k = 0;
+    for (; k + 8 <= numFrames; k += 8) {
+        const __m256 kf =
+            _mm256_add_ps(_mm256_set1_ps(static_cast<float>(k)), lane);
+        const __m256 sL = sin2PiAvx2<Tier>(vL.at(kf));
+        const __m256 sR = sin2PiAvx2<Tier>(vR.at(kf));
+        _mm256_storeu_ps(outL + k,
+                         _mm256_fmadd_ps(sL, vVol, _mm256_loadu_ps(outL + k)));
+        _mm256_storeu_ps(outR + k,
+                         _mm256_fmadd_ps(sR, vVol, _mm256_loadu_ps(outR + k)));
+    }
+    // 尾调用前编译器不一定插入 vzeroupper，之后的 SSE 代码（如 libm）会被拖慢
+    _mm256_zeroupper();
+    binauralTail<Tier>(outL, outR, k, numFrames, l, r, vol);
+}
+
+template <QualityTier Tier>
+BINAURAL_TARGET_AVX2 void isochronicAvx2(float* outL, float* outR,
+                                         int numFrames, const Ramp& carrier,
+                                         const Ramp& iso, float vol) {
+    const __m256 lane = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+    const RampAvx2 vC(carrier);
+    const RampAvx2 vI(iso);
+    const __m256 vVol = _mm256_set1_ps(vol);
+    int k = 0;
+    for (; k + 8 <= numFrames; k += 8) {
+        const __m256 kf =
+            _mm256_add_ps(_mm256_set1_ps(static_cast<float>(k)), lane);
+        const __m256 c = sin2PiAvx2<Tier>(vC.at(kf));
+        const __m256 g = isoGainAvx2<Tier>(vI.at(kf));
+        const __m256 s = _mm256_mul_ps(_mm256_mul_ps(c, g), vVol);
+        _mm256_storeu_ps(outL + k, _mm256_add_ps(_mm256_loadu_ps(outL + k), s));
+        _mm256_storeu_ps(outR + k, _mm256_add_ps(_mm256_loadu_ps(outR + k), s));
+    }
+    _mm256_zeroupper();
+    isochronicTail<Tier>(outL, outR, k, numFrames, carrier, iso, vol);
+}
+
+#endif  // BINAURAL_HAS_AVX2
+#endif  // BINAURAL_X86
+
+#if defined(BINAURAL_NEON)
+
+// ---- NEON (AArch64)：4 帧一组 ----
+
+template <QualityTier Tier>
+inline float32x4_t sinPiNeon(float32x4_t v) {
+    using P = SinPiPoly<Tier>;
+    const float32x4_t w = vmulq_f32(v, v);
+    float32x4_t q = vdupq_n_f32(P::C[P::N - 1]);
+    for (int i = P::N - 2; i >= 0; --i)
+        q = vfmaq_f32(vdupq_n_f32(P::C[i]), q, w);
+    return vmulq_f32(vfmsq_f32(v, v, w), q);
+}
+
+template <QualityTier Tier>
+inline float32x4_t sin2PiNeon(float32x4_t phase) {
+    const float32x4_t u = vsubq_f32(phase, vrndnq_f32(phase));
+    return sinPiNeon<Tier>(vaddq_f32(u, u));
+}
+
+template <QualityTier Tier>
+inline float32x4_t isoGainNeon(float32x4_t phase) {
+    const float32x4_t p = vsubq_f32(phase, vrndmq_f32(phase));
+    const uint32x4_t mask = vcltq_f32(p, vdupq_n_f32(0.5f));
+    const float32x4_t g = sinPiNeon<Tier>(vsubq_f32(vdupq_n_f32(0.5f), p));
+    return vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(g)));
+}
+
+struct RampNeon {
+    float32x4_t start, inc, curve;
+    explicit RampNeon(const Ramp& r)
+        : start(vdupq_n_f32(r.start)),
+          inc(vdupq_n_f32(r.inc)),
+          curve(vdupq_n_f32(r.curve)) {}
+    float32x4_t at(float32x4_t kf) const {
+        return vfmaq_f32(start, kf, vfmaq_f32(inc, kf, curve));
+    }
+};
+
+template <QualityTier Tier>
+void binauralNeon(float* outL, float* outR, int numFrames, const Ramp& l,
+                  const Ramp& r, float vol) {
+    const float laneInit[4] = {0.f, 1.f, 2.f, 3.f};
+    const float32x4_t lane = vld1q_f32(laneInit);
+    const RampNeon vL(l);
+    const RampNeon vR(r);
+    const float32x4_t vVol = vdupq_n_f32(vol);
+    int k = 0;
+    for (; k + 4 <= numFrames; k += 4) {
+        const float32x4_t kf =
+            vaddq_f32(vdupq_n_f32(static_cast<float>(k)), lane);
+        const float32x4_t sL = sin2PiNeon<Tier>(vL.at(kf));
+        const float32x4_t sR = sin2PiNeon<Tier>(vR.at(kf));
+        vst1q_f32(outL + k, vfmaq_f32(vld1q_f32(outL + k), sL, vVol));
+        vst1q_f32(outR + k, vfmaq_f32(vld1q_f32(outR + k), sR, vVol));
+    }
+    binauralTail<Tier>(outL, outR, k, numFrames, l, r, vol);
+}
+
+template <QualityTier Tier>
+void isochronicNeon(float* outL, float* outR, int numFrames,
+                    const Ramp& carrier, const Ramp& iso, float vol) {
+    const float laneInit[4] = {0.f, 1.f, 2.f, 3.f};
+    const float32x4_t lane = vld1q_f32(laneInit);
+    const RampNeon vC(carrier);
+    const RampNeon vI(iso);
+    int k = 0;
+    for (; k + 4 <= numFrames; k += 4) {
+        const float32x4_t kf =
+            vaddq_f32(vdupq_n_f32(static_cast<float>(k)), lane);
+        const float32x4_t c = sin2PiNeon<Tier>(vC.at(kf));
+        const float32x4_t g = isoGainNeon<Tier>(vI.at(kf));
+        const float32x4_t s = vmulq_n_f32(vmulq_f32(c, g), vol);
+        vst1q_f32(outL + k, vaddq_f32(vld1q_f32(outL + k), s));
+        vst1q_f32(outR + k, vaddq_f32(vld1q_f32(outR + k), s));
+    }
+    isochronicTail<Tier>(outL, outR, k, numFrames, carrier, iso, vol);
+}
+
+#endif  // BINAURAL_NEON
+
+constexpr int NUM_TIERS = 3;
+
+// 每个指令集按 QualityTier 顺序各实例化一组
+#define BINAURAL_KERNEL_SETS(LEVEL, SUFFIX)                                 \
+    {KernelSet{LEVEL, QualityTier::Draft,                                   \
+               binaural##SUFFIX<QualityTier::Draft>,                        \
+               isochronic##SUFFIX<QualityTier::Draft>},                     \
+     KernelSet{LEVEL, QualityTier::Standard,                                \
+               binaural##SUFFIX<QualityTier::Standard>,                     \
+               isochronic##SUFFIX<QualityTier::Standard>},                  \
+     KernelSet{LEVEL, QualityTier::Reference,                               \
+               binaural##SUFFIX<QualityTier::Reference>,                    \
+               isochronic##SUFFIX<QualityTier::Reference>}}
+
+const KernelSet SCALAR_KERNELS[NUM_TIERS] =
+    BINAURAL_KERNEL_SETS(SimdLevel::Scalar, Scalar);
+#if defined(BINAURAL_X86)
+const KernelSet SSE2_KERNELS[NUM_TIERS] =
+    BINAURAL_KERNEL_SETS(SimdLevel::Sse2, Sse2);
+#if defined(BINAURAL_HAS_AVX2)
+const KernelSet AVX2_KERNELS[NUM_TIERS] =
+    BINAURAL_KERNEL_SETS(SimdLevel::Avx2, Avx2);
+#endif
+#endif
+#if defined(BINAURAL_NEON)
+const KernelSet NEON_KERNELS[NUM_TIERS] =
+    BINAURAL_KERNEL_SETS(SimdLevel::Neon, Neon);
+#endif
+
+#undef BINAURAL_KERNEL_SETS
+
+// 周期 -> 32 位定点（2^32 对应一周期），负值按模回绕
+inline uint32_t toFixedPhase(float cycles) {
+    const double frac = cycles - std::floor(static_cast<double>(cycles));
+    return static_cast<uint32_t>(
+        static_cast<uint64_t>(frac * 4294967296.0) & 0xFFFFFFFFu);
+}
+
+// 定点相位累加器：相位与步进为 Q0.64（2^64 对应一周期），步进每帧加 2·curve。
+// 高 32 位查表；扫频的步进增量远小于 2^-32 周期，需要低位才不会被舍掉
+struct FixedRamp {
+    uint64_t phase;
+    uint64_t inc;
+    int64_t delta;
+
+    explicit FixedRamp(const Ramp& r)
+        : phase(static_cast<uint64_t>(toFixedPhase(r.start)) << 32),
+          // 第 0 帧到第 1 帧的相位差为 inc + curve
+          inc(toFixed64(static_cast<double>(r.inc) + r.curve)),
+          delta(static_cast<int64_t>(
+              std::llround(2.0 * r.curve * 18446744073709551616.0))) {}
+
+    uint32_t next() {
+        const uint32_t p = static_cast<uint32_t>(phase >> 32);
+        phase += inc;
+        inc += static_cast<uint64_t>(delta);
+        return p;
+    }
+
+    static uint64_t toFixed64(double cycles) {
+        const double frac = cycles - std::floor(cycles);
+        // 乘 2^64 后按 2^32 两段转换，避免超出 double→uint64 的范围
+        const double hi = std::floor(frac * 4294967296.0);
+        const double lo = (frac * 4294967296.0 - hi) * 4294967296.0;
+        return (static_cast<uint64_t>(hi) << 32) + static_cast<uint64_t>(lo);
+    }
+};
+
+// 与原 fillSamples 相同的逐帧 float 相位累加：phase += step，越过 1 回绕。
+// 扫频时第 k 帧的步进为 inc + (2k+1)·curve（phaseAt 二次式的差分），
+// 逐帧重算而不累加，curve = 0 时与原循环逐位一致
+struct FloatRamp {
+    float phase;
+    float inc;
+    float curve;
+    float k = 0.f;
+
+    explicit FloatRamp(const Ramp& r)
+        : phase(r.start - std::floor(r.start)), inc(r.inc), curve(r.curve) {}
+
+    void next() {
+        phase += inc + (2.0f * k + 1.0f) * curve;
+        k += 1.0f;
+        if (phase >= 1.0f) phase -= 1.0f;
+        if (phase < 0.0f) phase += 1.0f;
+    }
+};
+
+SimdLevel detectOnce() {
+#if defined(BINAURAL_X86)
+#if defined(BINAURAL_HAS_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdLevel::Avx2;
+#endif
+    return SimdLevel::Sse2;
+#elif defined(BINAURAL_NEON)
+    return SimdLevel::Neon;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+}  // namespace
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel level = detectOnce();
+    return level;
+}
+
+SimdLevel resolveSimdLevel(SimdLevel requested) {
+    const SimdLevel best = detectSimdLevel();
+    switch (requested) {
+        case SimdLevel::Scalar:
+            return SimdLevel::Scalar;
+        case SimdLevel::Sse2:
+            return best == SimdLevel::Avx2 ? SimdLevel::Sse2 : best;
+        case SimdLevel::Avx2:
+        case SimdLevel::Neon:
+            return requested == best ? requested : best;
+        case SimdLevel::Auto:
+        default:
+            return best;
+    }
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Auto:
+            return "auto";
+        case SimdLevel::Scalar:
+            return "scalar";
+        case SimdLevel::Sse2:
+            return "sse2";
+        case SimdLevel::Avx2:
+            return "avx2";
+        case SimdLevel::Neon:
+            return "neon";
+    }
+    return "unknown";
+}
+
+float maxSineError(QualityTier tier) {
+    switch (tier) {
+        case QualityTier::Draft:
+            return 3e-4f;
+        case QualityTier::Standard:
+            return 8e-6f;
+        case QualityTier::Reference:
+        default:
+            return 4e-7f;
+    }
+}
+
+float sin2Pi(QualityTier tier, float phase) {
+    switch (tier) {
+        case QualityTier::Draft:
+            return sin2PiPoly<QualityTier::Draft>(phase);
+        case QualityTier::Standard:
+            return sin2PiPoly<QualityTier::Standard>(phase);
+        case QualityTier::Reference:
+        default:
+            return sin2PiPoly<QualityTier::Reference>(phase);
+    }
+}
+
+const KernelSet& selectKernels(SimdLevel level, QualityTier tier) {
+    const int t = static_cast<int>(tier);
+    switch (resolveSimdLevel(level)) {
+#if defined(BINAURAL_X86)
+        case SimdLevel::Sse2:
+            return SSE2_KERNELS[t];
+#if defined(BINAURAL_HAS_AVX2)
+        case SimdLevel::Avx2:
+            return AVX2_KERNELS[t];
+#endif
+#endif
+#if defined(BINAURAL_NEON)
+        case SimdLevel::Neon:
+            return NEON_KERNELS[t];
+#endif
+        default:
+            return SCALAR_KERNELS[t];
+    }
+}
+
+void binauralLibm(float* outL, float* outR, int numFrames, const Ramp& l,
+                  const Ramp& r, float vol) {
+    FloatRamp pL(l);
+    FloatRamp pR(r);
+    for (int k = 0; k < numFrames; ++k) {
+        outL[k] += std::sin(TWO_PI * pL.phase) * vol;
+        outR[k] += std::sin(TWO_PI * pR.phase) * vol;
+        pL.next();
+        pR.next();
+    }
+}
+
+void isochronicLibm(float* outL, float* outR, int numFrames,
+                    const Ramp& carrier, const Ramp& iso, float vol) {
+    FloatRamp pC(carrier);
+    FloatRamp pI(iso);
+    for (int k = 0; k < numFrames; ++k) {
+        const float gain =
+            pI.phase < 0.5f ? std::cos(pI.phase * 3.14159265f) : 0.f;
+        const float s = std::sin(TWO_PI * pC.phase) * vol * gain;
+        outL[k] += s;
+        outR[k] += s;
+        pC.next();
+        pI.next();
+    }
+}
+
+void binauralTable(const SinTable& table, float* outL, float* outR,
+                   int numFrames, const Ramp& l, const Ramp& r, float vol) {
+    for (int k = 0; k < numFrames; ++k) {
+        const float kf = static_cast<float>(k);
+        outL[k] +=
+            table.sinFastFloat(phaseAt(l.start, l.inc, l.curve, kf)) * vol;
+        outR[k] +=
+            table.sinFastFloat(phaseAt(r.start, r.inc, r.curve, kf)) * vol;
+    }
+}
+
+void isochronicTable(const SinTable& table, float* outL, float* outR,
+                     int numFrames, const Ramp& carrier, const Ramp& iso,
+                     float vol) {
+    for (int k = 0; k < numFrames; ++k) {
+        const float kf = static_cast<float>(k);
+        float pI = phaseAt(iso.start, iso.inc, iso.curve, kf);
+        pI -= std::floor(pI);
+        // cos(π·p) = sin(2π·(0.25 - p/2))
+        const float gain =
+            pI < 0.5f ? table.sinFastFloat(0.25f - 0.5f * pI) : 0.f;
+        const float s =
+            table.sinFastFloat(
+                phaseAt(carrier.start, carrier.inc, carrier.curve, kf)) *
+            gain * vol;
+        outL[k] += s;
+        outR[k] += s;
+    }
+}
+
+void binauralFixedPoint(const SinTable& table, float* outL, float* outR,
+                        int numFrames, const Ramp& l, const Ramp& r,
+                        float vol) {
+    FixedRamp pL(l);
+    FixedRamp pR(r);
+    for (int k = 0; k < numFrames; ++k) {
+        outL[k] += table.sinFixed(pL.next()) * vol;
+        outR[k] += table.sinFixed(pR.next()) * vol;
+    }
+}
+
+void isochronicFixedPoint(const SinTable& table, float* outL, float* outR,
+                          int numFrames, const Ramp& carrier, const Ramp& iso,
+                          float vol) {
+    constexpr uint32_t QUARTER = 1u << 30;
+    constexpr uint32_t HALF = 1u << 31;
+    FixedRamp pC(carrier);
+    FixedRamp pI(iso);
+    for (int k = 0; k < numFrames; ++k) {
+        const uint32_t i = pI.next();
+        const float gain = i < HALF ? table.sinFixed(QUARTER - (i >> 1)) : 0.f;
+        const float s = table.sinFixed(pC.next()) * gain * vol;
+        outL[k] += s;
+        outR[k] += s;
+    }
+}
+
+}  // namespace kernels
+
+const char* oscillatorBackendName(OscillatorBackend backend) {
+    switch (backend) {
+        case OscillatorBackend::Polynomial:
+            return "poly";
+        case OscillatorBackend::Libm:
+            return "libm";
+        case OscillatorBackend::Table:
+            return "table";
+        case OscillatorBackend::FixedPoint:
+            return "fixed";
+    }
+    return "unknown";
+}
+
+const char* qualityTierName(QualityTier tier) {
+    switch (tier) {
+        case QualityTier::Draft:
+            return "draft";
+        case QualityTier::Standard:
+            return "standard";
+        case QualityTier::Reference:
+            return "reference";
+    }
+    return "unknown";
+}
+
+}  // namespace binaural
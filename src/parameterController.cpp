@@ -1,5 +1,6 @@
 #include "binaural/parameterController.hpp"
 #include "binaural/period.hpp"
+#include "binaural/trace.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -14,12 +15,13 @@ ParameterController::ParameterController(Synthesizer &synth,
                                          PredictionQueue &queue)
     : synth_(&synth), queue_(&queue) {}
 
-void ParameterController::update(float periodElapsedSec) {
+void ParameterController::update() {
+  BINAURAL_TRACE_SCOPE("ParameterController::update");
   if (clearRequested_.exchange(false, std::memory_order_acq_rel)) {
     lastPrediction_.reset();
     currentTargetHz_ = 0.f;
     aiDriven_.store(false, std::memory_order_release);
-    synth_->skewVoices(periodElapsedSec);
+    resumeSchedule();
     return;
   }
 
@@ -47,17 +49,22 @@ void ParameterController::update(float periodElapsedSec) {
     currentTargetHz_ =
         std::clamp(currentTargetHz_, BEAT_FREQ_MIN, BEAT_FREQ_MAX);
 
-    if (const Period *period = synth_->currentPeriod()) {
-      size_t n = period->voices.size();
-      std::vector<float> freqs(n, currentTargetHz_);
-      synth_->setFreqs(freqs);
-    }
+    synth_->setAllFreqs(currentTargetHz_);
+    overriding_ = true;
   } else {
     aiDriven_.store(false, std::memory_order_release);
     lastPrediction_.reset();
     currentTargetHz_ = 0.f;
-    synth_->skewVoices(periodElapsedSec);
+    resumeSchedule();
   }
 }
 
+void ParameterController::resumeSchedule() {
+  // 只在此前覆盖过节拍时交还日程，不干扰 UI 的手动 setFreqs
+  if (!overriding_)
+    return;
+  overriding_ = false;
+  synth_->resumeSchedule();
+}
+
 } // namespace binaural
@@ -1,4 +1,6 @@
 #include "binaural/pinkNoise.hpp"
+#include "binaural/whiteNoise.hpp"
+#include <algorithm>
 
 namespace binaural {
 
@@ -7,31 +9,81 @@ namespace {
 constexpr float A[] = {0.02109238f, 0.07113478f, 0.68873558f};
 constexpr float P[] = {0.3190f, 0.7756f, 0.9613f};
 constexpr float OFFSET = A[0] + A[1] + A[2];
-} // namespace
+constexpr float RMI2 = 2.0f / 32767.0f;
+// 每级随机数流的 key 偏移
+constexpr uint32_t STAGE_KEY = 0x632BE5ABu;
+}  // namespace
 
-float PinkNoise::randFloat(unsigned int &seed) {
-  seed = seed * 1103515245u + 12345u;
-  return (seed >> 16) / 65536.0f;
+PinkNoise::PinkNoise(uint32_t seed) {
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        keys_[i] = seed + STAGE_KEY * static_cast<uint32_t>(i);
+    }
+    clear();
 }
 
-PinkNoise::PinkNoise() : seed_(1u) { clear(); }
-
 void PinkNoise::clear() {
-  for (int i = 0; i < NUM_STAGES; ++i) {
-    state_[i] = 0.f;
-  }
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        state_[i] = 0.f;
+    }
 }
 
+// s' = P·(s - t) + t 改写为 s' = P·s + (1 - P)·t，t 为 [0, 32767) 均匀随机数
 float PinkNoise::tick() {
-  constexpr float RMI2 = 2.0f / 32767.0f;
-  float temp = randFloat(seed_) * 32767.0f;
-  state_[0] = P[0] * (state_[0] - temp) + temp;
-  temp = randFloat(seed_) * 32767.0f;
-  state_[1] = P[1] * (state_[1] - temp) + temp;
-  temp = randFloat(seed_) * 32767.0f;
-  state_[2] = P[2] * (state_[2] - temp) + temp;
-  return (A[0] * state_[0] + A[1] * state_[1] + A[2] * state_[2]) * RMI2 -
-         OFFSET;
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        const float u =
+            noise::uniform(keys_[i], counter_) * (1.0f - P[i]) * 32767.0f;
+        state_[i] = P[i] * state_[i] + u;
+    }
+    ++counter_;
+    return (A[0] * state_[0] + A[1] * state_[1] + A[2] * state_[2]) * RMI2 -
+           OFFSET;
+}
+
+void PinkNoise::generate(float* out, size_t n) {
+    constexpr size_t CHUNK = 256;
+    // 一阶递推按 LOOKAHEAD 帧分段：段内从 0 起算的局部递推与上一段无关，
+    // 段间只剩 s_{k+L} = v_{L-1} + P^L·s_k 一次乘加，依赖链缩短为 1/L。
+    // 与逐个 tick() 的差异仅为 float 舍入
+    constexpr size_t LOOKAHEAD = 8;
+    float stage[NUM_STAGES][CHUNK];
+    while (n > 0) {
+        const size_t m = std::min(n, CHUNK);
+        for (int i = 0; i < NUM_STAGES; ++i) {
+            float* u = stage[i];
+            noise::uniformBlock(keys_[i], counter_, u, m);
+            const float p = P[i];
+            const float q = (1.0f - p) * 32767.0f;
+            for (size_t k = 0; k < m; ++k) u[k] *= q;
+
+            float pw[LOOKAHEAD];
+            pw[0] = p;
+            for (size_t j = 1; j < LOOKAHEAD; ++j) pw[j] = pw[j - 1] * p;
+
+            float s = state_[i];
+            size_t k = 0;
+            for (; k + LOOKAHEAD <= m; k += LOOKAHEAD) {
+                float v = 0.f;
+                for (size_t j = 0; j < LOOKAHEAD; ++j) {
+                    v = p * v + u[k + j];
+                    u[k + j] = v + pw[j] * s;
+                }
+                s = u[k + LOOKAHEAD - 1];
+            }
+            for (; k < m; ++k) {
+                s = p * s + u[k];
+                u[k] = s;
+            }
+            state_[i] = s;
+        }
+        for (size_t k = 0; k < m; ++k) {
+            const float sum =
+                A[0] * stage[0][k] + A[1] * stage[1][k] + A[2] * stage[2][k];
+            out[k] = sum * RMI2 - OFFSET;
+        }
+        out += m;
+        counter_ += m;
+        n -= m;
+    }
 }
 
-} // namespace binaural
+}  // namespace binaural
@@ -0,0 +1,74 @@
+#include "binaural/programExchange.hpp"
+#include <chrono>
+
+namespace binaural {
+
+namespace {
+// 回收线程的轮询间隔：音频线程不做任何唤醒（notify 可能进入内核），
+// 退役状态最多多驻留这么久
+constexpr auto RECLAIM_INTERVAL = std::chrono::milliseconds(100);
+}  // namespace
+
+ProgramExchange::ProgramExchange(const Synthesizer& synth) : synth_(synth) {
+    reclaimer_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(reclaimMutex_);
+        while (!stop_) {
+            reclaimWake_.wait_for(lock, RECLAIM_INTERVAL);
+            drain();
+        }
+    });
+}
+
+ProgramExchange::~ProgramExchange() {
+    {
+        std::lock_guard<std::mutex> lock(reclaimMutex_);
+        stop_ = true;
+    }
+    reclaimWake_.notify_one();
+    reclaimer_.join();
+    delete pending_.exchange(nullptr, std::memory_order_acquire);
+    reclaim();
+}
+
+void ProgramExchange::publish(const Program& program, bool continuous) {
+    Node* node = new Node{synth_.prepareProgram(program, continuous)};
+    published_.fetch_add(1, std::memory_order_relaxed);
+    // 被替换的快照从未到达音频线程，在发布线程上直接释放
+    delete pending_.exchange(node, std::memory_order_acq_rel);
+}
+
+bool ProgramExchange::apply(Synthesizer& synth) {
+    Node* node = pending_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!node) return false;
+    synth.adoptProgram(*node->state);
+    // node 现在持有换下的旧状态
+    retire(node);
+    applied_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ProgramExchange::retire(Node* node) {
+    node->next = retired_.load(std::memory_order_relaxed);
+    while (!retired_.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+}
+
+void ProgramExchange::reclaim() {
+    // 与回收线程互斥：返回时此前退役的状态都已释放，不会有一批还在对方手里
+    std::lock_guard<std::mutex> lock(reclaimMutex_);
+    drain();
+}
+
+void ProgramExchange::drain() {
+    Node* node = retired_.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+        Node* next = node->next;
+        delete node;
+        reclaimed_.fetch_add(1, std::memory_order_relaxed);
+        node = next;
+    }
+}
+
+}  // namespace binaural
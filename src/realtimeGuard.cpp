@@ -0,0 +1,82 @@
+#include "binaural/realtimeGuard.hpp"
+
+#if !defined(NDEBUG) && !defined(BINAURAL_NO_RT_ALLOC_CHECK)
+#define BINAURAL_RT_ALLOC_CHECK 1
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace binaural {
+
+namespace {
+thread_local int realtimeDepth = 0;
+}  // namespace
+
+RealtimeScope::RealtimeScope() { ++realtimeDepth; }
+
+RealtimeScope::~RealtimeScope() { --realtimeDepth; }
+
+bool inRealtimeScope() { return realtimeDepth > 0; }
+
+bool realtimeAllocCheckEnabled() {
+#if defined(BINAURAL_RT_ALLOC_CHECK)
+    return true;
+#else
+    return false;
+#endif
+}
+
+}  // namespace binaural
+
+#if defined(BINAURAL_RT_ALLOC_CHECK)
+
+// 替换全局 operator new/delete；对齐版本保留标准库实现（本项目未使用）
+namespace {
+
+void* checkedAlloc(std::size_t size) {
+    assert(!binaural::inRealtimeScope() &&
+           "heap allocation on real-time audio thread");
+    if (size == 0) size = 1;
+    return std::malloc(size);
+}
+
+void checkedFree(void* p) {
+    if (!p) return;
+    assert(!binaural::inRealtimeScope() &&
+           "heap deallocation on real-time audio thread");
+    std::free(p);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = checkedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = checkedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return checkedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return checkedAlloc(size);
+}
+
+void operator delete(void* p) noexcept { checkedFree(p); }
+void operator delete[](void* p) noexcept { checkedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { checkedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { checkedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    checkedFree(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    checkedFree(p);
+}
+
+#endif  // BINAURAL_RT_ALLOC_CHECK
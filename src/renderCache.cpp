@@ -0,0 +1,227 @@
+#include "binaural/renderCache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace binaural {
+
+namespace {
+constexpr char MAGIC[4] = {'B', 'B', 'R', 'C'};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr const char* EXTENSION = ".bbrc";
+// 魔数 4 + 版本 4 + 帧数 8 + 键长 4，样本区按 DATA_ALIGN 对齐
+constexpr size_t FIXED_HEADER = 20;
+constexpr size_t DATA_ALIGN = 64;
+
+size_t dataOffset(size_t keyBytes) {
+    return (FIXED_HEADER + keyBytes + DATA_ALIGN - 1) / DATA_ALIGN *
+           DATA_ALIGN;
+}
+
+// 头部字段按主机字节序写出（目标平台均为小端），与样本一致
+template <typename T>
+void put(std::string& out, T v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+T get(const char* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+}  // namespace
+
+RenderCache::Writer::~Writer() { discard(); }
+
+RenderCache::Writer::Writer(Writer&& other) noexcept { *this = std::move(other); }
+
+RenderCache::Writer& RenderCache::Writer::operator=(Writer&& other) noexcept {
+    if (this != &other) {
+        discard();
+        cache_ = other.cache_;
+        file_ = std::move(other.file_);
+        tmpPath_ = std::move(other.tmpPath_);
+        path_ = std::move(other.path_);
+        remaining_ = other.remaining_;
+        other.cache_ = nullptr;
+        other.remaining_ = 0;
+    }
+    return *this;
+}
+
+void RenderCache::Writer::discard() {
+    if (!file_.is_open()) return;
+    file_.close();
+    std::error_code ec;
+    fs::remove(tmpPath_, ec);
+}
+
+bool RenderCache::Writer::append(const int16_t* samples, size_t frames) {
+    if (!file_.is_open() || frames > remaining_) {
+        discard();
+        return false;
+    }
+    const size_t bytes = frames * 2 * sizeof(int16_t);
+    file_.write(reinterpret_cast<const char*>(samples),
+                static_cast<std::streamsize>(bytes));
+    if (!file_) {
+        discard();
+        return false;
+    }
+    remaining_ -= frames;
+    cache_->stats_.bytesWritten += bytes;
+    return true;
+}
+
+bool RenderCache::Writer::commit() {
+    if (!file_.is_open() || remaining_ != 0) {
+        discard();
+        return false;
+    }
+    file_.close();
+    std::error_code ec;
+    if (file_.fail()) {
+        fs::remove(tmpPath_, ec);
+        return false;
+    }
+    // 同目录 rename 原子替换，读者不会看到写了一半的条目
+    fs::rename(tmpPath_, path_, ec);
+    if (ec) {
+        fs::remove(tmpPath_, ec);
+        return false;
+    }
+    cache_->evict(path_);
+    return true;
+}
+
+RenderCache::RenderCache(std::string dir, uint64_t maxBytes)
+    : dir_(std::move(dir)), maxBytes_(maxBytes) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    // 容量调小后立即生效
+    evict({});
+}
+
+uint64_t RenderCache::fnv1a(const std::string& bytes) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : bytes) {
+        h ^= c;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+std::string RenderCache::pathOf(const std::string& key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx",
+                  static_cast<unsigned long long>(fnv1a(key)));
+    return (fs::path(dir_) / (std::string(name) + EXTENSION)).string();
+}
+
+bool RenderCache::read(const std::string& key, uint64_t offset, int16_t* out,
+                       size_t frames) {
+    const std::string path = pathOf(key);
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> header(dataOffset(key.size()));
+    bool ok = static_cast<bool>(in) &&
+              in.read(header.data(), static_cast<std::streamsize>(
+                                         header.size())) &&
+              std::memcmp(header.data(), MAGIC, 4) == 0 &&
+              get<uint32_t>(header.data() + 4) == FORMAT_VERSION &&
+              get<uint32_t>(header.data() + 16) == key.size() &&
+              std::memcmp(header.data() + FIXED_HEADER, key.data(),
+                          key.size()) == 0 &&
+              offset + frames <= get<uint64_t>(header.data() + 8);
+    const size_t bytes = frames * 2 * sizeof(int16_t);
+    if (ok) {
+        in.seekg(static_cast<std::streamoff>(header.size() +
+                                             offset * 2 * sizeof(int16_t)));
+        ok = static_cast<bool>(
+            in.read(reinterpret_cast<char*>(out),
+                    static_cast<std::streamsize>(bytes)));
+    }
+    if (!ok) {
+        ++stats_.misses;
+        return false;
+    }
+    ++stats_.hits;
+    stats_.bytesRead += bytes;
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+RenderCache::Writer RenderCache::beginWrite(const std::string& key,
+                                            uint64_t frames) {
+    Writer w;
+    w.cache_ = this;
+    w.path_ = pathOf(key);
+    w.tmpPath_ = w.path_ + ".tmp";
+    w.remaining_ = frames;
+    // 单个条目超过容量时不缓存
+    if (dataOffset(key.size()) + frames * 2 * sizeof(int16_t) > maxBytes_)
+        return w;
+    w.file_.open(w.tmpPath_, std::ios::binary | std::ios::trunc);
+    if (!w.file_) return w;
+
+    std::string header(MAGIC, 4);
+    put<uint32_t>(header, FORMAT_VERSION);
+    put<uint64_t>(header, frames);
+    put<uint32_t>(header, static_cast<uint32_t>(key.size()));
+    header += key;
+    header.resize(dataOffset(key.size()), '\0');
+    w.file_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    if (!w.file_) w.discard();
+    return w;
+}
+
+uint64_t RenderCache::sizeBytes() const {
+    uint64_t total = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir_, ec)) {
+        if (entry.path().extension() == EXTENSION)
+            total += entry.file_size(ec);
+    }
+    return total;
+}
+
+void RenderCache::evict(const std::string& keep) {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type time;
+        uint64_t size;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir_, ec)) {
+        if (entry.path().extension() != EXTENSION) continue;
+        const uint64_t size = entry.file_size(ec);
+        entries.push_back({entry.path(), entry.last_write_time(ec), size});
+        total += size;
+    }
+    if (total <= maxBytes_) return;
+    // 最久未使用的在前；刚写入的条目最后淘汰
+    std::sort(entries.begin(), entries.end(),
+              [&keep](const Entry& a, const Entry& b) {
+                  const bool ka = a.path == keep;
+                  const bool kb = b.path == keep;
+                  if (ka != kb) return kb;
+                  return a.time < b.time;
+              });
+    for (const Entry& e : entries) {
+        if (total <= maxBytes_) break;
+        if (fs::remove(e.path, ec)) {
+            total -= e.size;
+            ++stats_.evictions;
+        }
+    }
+}
+
+}  // namespace binaural
@@ -1,5 +1,5 @@
 #include "binaural/sinTable.hpp"
-#include <cmath>
+#include <algorithm>
 
 namespace binaural {
 
@@ -7,35 +7,38 @@ namespace {
 constexpr double PI = 3.14159265358979323846;
 }
 
-SinTable::SinTable(int size) : size_(size) {
-    tableSin_.resize(size);
-    tableCos_.resize(size);
-    const double step = 2.0 * PI / size;
-    for (int i = 0; i < size; ++i) {
+SinTable::SinTable(int size) : size_(std::max(size, 2)) {
+    if ((size_ & (size_ - 1)) == 0) {
+        mask_ = size_ - 1;
+        while ((1 << bits_) < size_) ++bits_;
+    }
+    tableSin_.resize(size_ + 1);
+    tableCos_.resize(size_ + 1);
+    const double step = 2.0 * PI / size_;
+    for (int i = 0; i < size_; ++i) {
         tableSin_[i] = static_cast<float>(std::sin(step * i));
         tableCos_[i] = static_cast<float>(std::cos(step * i));
     }
+    tableSin_[size_] = tableSin_[0];
+    tableCos_[size_] = tableCos_[0];
 }
 
 float SinTable::sinFastInt(int angle) const {
-    int idx = angle % size_;
+    int idx = mask_ ? (angle & mask_) : angle % size_;
     if (idx < 0) idx += size_;
     return tableSin_[idx];
 }
 
 float SinTable::cosFastInt(int angle) const {
-    int idx = angle % size_;
+    int idx = mask_ ? (angle & mask_) : angle % size_;
     if (idx < 0) idx += size_;
     return tableCos_[idx];
 }
 
-float SinTable::sinFastFloat(float phase) const {
-    phase -= std::floor(phase);
-    const float scaled = phase * static_cast<float>(size_);
-    const int i0 = static_cast<int>(scaled) % size_;
-    const int i1 = (i0 + 1) % size_;
-    const float frac = scaled - std::floor(scaled);
-    return tableSin_[i0] * (1.f - frac) + tableSin_[i1] * frac;
+int SinTable::nextPowerOfTwo(int n) {
+    int p = 2;
+    while (p < n && p < (1 << 30)) p <<= 1;
+    return p;
 }
 
 }  // namespace binaural
@@ -1,4 +1,6 @@
 #include "binaural/synthesizer.hpp"
+#include "binaural/realtimeGuard.hpp"
+#include "binaural/trace.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -6,11 +8,6 @@ namespace binaural {
 
 namespace {
 constexpr float A_FREQ = 432.0f;
-float whiteNoise(unsigned int& seed) {
-    seed = seed * 1103515245u + 12345u;
-    return ((seed >> 16) / 32768.0f) - 1.0f;
-}
-constexpr float TWO_PI = 6.283185307f;
 constexpr float FADE_INOUT_PERIOD = 5.0f;
 constexpr float FADE_MIN = 0.6f;
 
@@ -19,177 +16,826 @@ constexpr float FADE_MIN = 0.6f;
 float getPitchFreq(int noteK, int octave) {
     return std::pow(2.0f, noteK / 12.0f + octave - 4) * A_FREQ;
 }
+
+// 内核最宽的 SIMD 组（AVX2 8 帧）。块的前缀按整组渲染，与整块渲染逐位一致
+constexpr int KERNEL_GROUP = 8;
+// 粉红噪声滤波器定位时至少补算的帧数（向上取整到整块）；P 最大 0.9613，
+// 初始状态的影响衰减到 0.9613^4096，远低于 float 精度。按帧而不是按块
+// 计，小 bufferFrames 时同样足够
+constexpr int64_t PINK_SETTLE_FRAMES = 4096;
+
+int64_t pinkSettleBlocks(int64_t blockFrames) {
+    return (PINK_SETTLE_FRAMES + blockFrames - 1) / blockFrames;
+}
+// 合成结果改变（算法、噪声序列、时间线规则）时递增，使磁盘缓存的旧条目失效
+constexpr uint32_t OUTPUT_VERSION = 6;
+
+// 噪声状态只在 program 层面开启时推进，与音量倍率无关
+bool noiseActive(const Period& period) {
+    return period.background != Period::Background::None &&
+           period.backgroundVol > 0.f;
+}
+
+bool pinkActive(const Period& period) {
+    return noiseActive(period) &&
+           period.background == Period::Background::PinkNoise;
+}
+
+// 节拍日程：每个 voice 沿自己的 freqStart -> freqEnd 线性变化
+struct Schedule {
+    float beat;    // period 起点 (Hz)
+    double slope;  // Hz/帧；float 在长 period 上会累积可闻的相位误差
+};
+
+Schedule scheduleOf(const Period& period, size_t voice, int sampleRate) {
+    const auto& v = period.voices[voice];
+    const int64_t frames = periodFrames(period, sampleRate);
+    if (frames <= 0) return {v.freqStart, 0.f};
+    return {v.freqStart,
+            (static_cast<double>(v.freqEnd) - v.freqStart) /
+                static_cast<double>(frames)};
+}
+
+// 混音值为 int16 量级，float 输出归一化到 [-1, 1)
+template <typename Sample>
+Sample toSample(float v);
+
+template <>
+int16_t toSample<int16_t>(float v) {
+    return static_cast<int16_t>(std::clamp(v, -32768.0f, 32767.0f));
+}
+
+template <>
+float toSample<float>(float v) {
+    return std::clamp(v, -32768.0f, 32767.0f) * (1.0f / 32768.0f);
+}
+
+// 混音增益，已折入 fade、音量倍率、声像与 voice 数归一化；
+// 参数过渡中也用来表示每帧的增量
+struct MixGains {
+    float voiceL, voiceR;
+    float noiseL, noiseR;
+
+    bool balanced() const { return voiceL == voiceR && noiseL == noiseR; }
+};
+
+MixGains mixGains(const Period& period, float fade, float volume,
+                  float balance) {
+    const float numVoices = static_cast<float>(period.voices.size());
+    const float multL = 1.0f - std::max(0.0f, balance);
+    const float multR = 1.0f - std::max(0.0f, -balance);
+    const float voice = 32767.0f / numVoices * volume;
+    const float noise = period.backgroundVol * fade * volume * 0.5f * 32767.0f;
+    return {voice * multL, voice * multR, noise * multL, noise * multR};
+}
+
+// 参数过渡中每帧的增益增量：首帧 from，numFrames 帧后到 to
+MixGains gainSteps(const MixGains& from, const MixGains& to, int numFrames) {
+    const float inv = 1.0f / static_cast<float>(numFrames);
+    return {(to.voiceL - from.voiceL) * inv, (to.voiceR - from.voiceR) * inv,
+            (to.noiseL - from.noiseL) * inv, (to.noiseR - from.noiseR) * inv};
+}
+
+// 特化混音循环：是否有噪声、声像是否居中、是否有发声 voice、增益是否在
+// 过渡中均在编译期确定，逐样本无分支。噪声已整块生成在 noise 中；
+// Balanced 时左右增益相同，只用 L 侧；Ramped 时第 f 帧增益为 g + step * f
+template <bool HasVoices, bool HasNoise, bool Balanced, bool Ramped,
+          typename Sample>
+void mixKernel(const float* wsL, const float* wsR, const float* noise,
+               int numFrames, const MixGains& g, const MixGains& step,
+               Sample* out) {
+    for (int f = 0; f < numFrames; ++f) {
+        float voiceL = g.voiceL;
+        float noiseL = g.noiseL;
+        float voiceR = Balanced ? voiceL : g.voiceR;
+        float noiseR = Balanced ? noiseL : g.noiseR;
+        if constexpr (Ramped) {
+            const float t = static_cast<float>(f);
+            voiceL += step.voiceL * t;
+            noiseL += step.noiseL * t;
+            voiceR = Balanced ? voiceL : voiceR + step.voiceR * t;
+            noiseR = Balanced ? noiseL : noiseR + step.noiseR * t;
+        }
+        float valL = 0.f;
+        float valR = 0.f;
+        if constexpr (HasVoices) {
+            valL = wsL[f] * voiceL;
+            valR = wsR[f] * voiceR;
+        }
+        if constexpr (HasNoise) {
+            valL += noise[f] * noiseL;
+            valR += noise[f] * noiseR;
+        }
+        out[f * 2] = toSample<Sample>(valL);
+        out[f * 2 + 1] = toSample<Sample>(valR);
+    }
+}
+
+template <typename Sample>
+using MixFn = void (*)(const float*, const float*, const float*, int,
+                       const MixGains&, const MixGains&, Sample*);
+
+template <typename Sample, bool HasVoices, bool HasNoise, bool Ramped>
+MixFn<Sample> selectMixKernel(bool balanced) {
+    return balanced ? mixKernel<HasVoices, HasNoise, true, Ramped, Sample>
+                    : mixKernel<HasVoices, HasNoise, false, Ramped, Sample>;
+}
+
+template <typename Sample, bool Ramped>
+MixFn<Sample> selectMixKernel(bool hasVoices, bool hasNoise, bool balanced) {
+    if (hasVoices) {
+        return hasNoise
+                   ? selectMixKernel<Sample, true, true, Ramped>(balanced)
+                   : selectMixKernel<Sample, true, false, Ramped>(balanced);
+    }
+    return hasNoise ? selectMixKernel<Sample, false, true, Ramped>(balanced)
+                    : selectMixKernel<Sample, false, false, Ramped>(balanced);
+}
 }  // namespace
 
-Synthesizer::Synthesizer(const SynthesizerConfig& config) : config_(config) {}
+Synthesizer::Synthesizer(const SynthesizerConfig& config)
+    : config_(config),
+      kernels_(&kernels::selectKernels(config.simd, config.quality)),
+      sinTable_(config.oscillator == OscillatorBackend::Table ||
+                        config.oscillator == OscillatorBackend::FixedPoint
+                    ? SinTable::nextPowerOfTwo(config.iscale)
+                    : 2),
+      crossfadeFrames_(static_cast<int64_t>(config.sampleRate) *
+                       std::max(config.crossfadeMs, 0) / 1000),
+      paramRampFrames_(std::max<int64_t>(
+          static_cast<int64_t>(config.sampleRate) * PARAM_RAMP_MS / 1000,
+          1)) {
+    const size_t blockFrames =
+        static_cast<size_t>(std::max(config_.bufferFrames, 1));
+    scratchL_.assign(blockFrames, 0.f);
+    scratchR_.assign(blockFrames, 0.f);
+    scratchNoise_.assign(blockFrames, 0.f);
+    if (crossfadeFrames_ > 0) {
+        tailL_.assign(blockFrames, 0.f);
+        tailR_.assign(blockFrames, 0.f);
+    }
+}
 
 void Synthesizer::setProgram(const Program& program) {
-    program_ = program;
+    adoptProgram(*prepareProgram(program));
+}
+
+std::unique_ptr<Synthesizer::PreparedProgram> Synthesizer::prepareProgram(
+    const Program& program, bool continuous) const {
+    auto prepared = std::make_unique<PreparedProgram>();
+    prepared->program = program;
+    prepared->continuous = continuous;
+    buildTimeline(*prepared);
+    return prepared;
+}
+
+void Synthesizer::adoptProgram(PreparedProgram& prepared) {
+    // 连续切换须在交换前把正在发声的相位推进到渲染位置
+    const bool carry =
+        prepared.continuous && !program_.seq.empty() &&
+        voicesPeriodIndex_ == currentPeriodIndex_ &&
+        prepared.program.seq.size() == program_.seq.size() &&
+        prepared.program.seq[currentPeriodIndex_].voices.size() ==
+            program_.seq[currentPeriodIndex_].voices.size();
+    const int carryPeriod = currentPeriodIndex_;
+    int64_t carryFrame = renderFrame_;
+    const int carryTail = tailPeriod_;
+    if (carry) reanchor(renderFrame_);
+
+    // 成员逐个交换：vector/string 只交换指针，不触碰堆
+    std::swap(program_, prepared.program);
+    timeline_.swap(prepared.timeline);
+    entryPhaseA_.swap(prepared.entryPhaseA);
+    entryPhaseB_.swap(prepared.entryPhaseB);
+    std::swap(loopPhases_, prepared.loopPhases);
+    std::swap(programFrames_, prepared.programFrames);
+    std::swap(voices_, prepared.voices);
+    std::swap(tailVoices_, prepared.tailVoices);
+    voicesPeriodIndex_ = -1;
+    tailPeriod_ = -1;
+    pinkFrame_ = -1;
+    pinkBlockFrame_ = -1;
+    noiseBlock_ = -1;
+    if (carry) {
+        // 换下的 voice 状态此时在 prepared.voices 中，锚点在渲染位置
+        carryFrame = std::min(
+            carryFrame,
+            periodFrames(program_.seq[carryPeriod], config_.sampleRate));
+        rebaseTimeline(carryPeriod, carryFrame, prepared.voices);
+        // 新时间线从正在播放的这一轮推出，轮次重新从 0 计
+        loop_ = 0;
+        locate(carryPeriod, carryFrame);
+        // 淡出中的 voice 也沿用换下前的相位（锚点同在上一 period 起点）；
+        // 新时间线的进入相位从 program 起点推出，可能与正在发声的不同
+        if (carryTail >= 0 && tailPeriod_ == carryTail &&
+            prepared.program.seq[carryTail].voices.size() ==
+                program_.seq[carryTail].voices.size()) {
+            const VoiceBank& live = prepared.tailVoices;
+            for (size_t j = 0; j < tailVoices_.size(); ++j) {
+                tailVoices_.phaseA[tailVoices_.slotOf(j)] =
+                    live.phaseA[live.slotOf(j)];
+                tailVoices_.phaseB[tailVoices_.slotOf(j)] =
+                    live.phaseB[live.slotOf(j)];
+            }
+        }
+        publishClock();
+        return;
+    }
     currentPeriodIndex_ = 0;
-    periodElapsedSec_ = 0.f;
-    ensureStateSize();
+    renderFrame_ = 0;
+    clockPeriod_ = 0;
+    periodFrame_ = 0;
+    loop_ = 0;
+    seek(0, 0);
 }
 
 void Synthesizer::setFreqs(const std::vector<float>& freqs) {
-    freqs_ = freqs;
+    setFreqs(freqs.data(), freqs.size());
+}
+
+void Synthesizer::setFreqs(const float* freqs, size_t n) {
+    BeatOverride beats;
+    beats.kind = BeatOverride::Kind::PerVoice;
+    beats.count = static_cast<uint32_t>(
+        std::min(n, BeatOverride::MAX_VOICES));
+    std::copy(freqs, freqs + beats.count, beats.hz);
+    mailbox_.postBeats(beats);
+}
+
+void Synthesizer::setAllFreqs(float hz) {
+    BeatOverride beats;
+    beats.kind = BeatOverride::Kind::All;
+    beats.count = 1;
+    beats.hz[0] = hz;
+    mailbox_.postBeats(beats);
 }
 
 void Synthesizer::setVolumeMultiplier(float v) {
-    volumeMultiplier_ = std::clamp(v, 0.0f, 2.0f);
+    mailbox_.setVolume(std::clamp(v, 0.0f, 2.0f));
 }
 
 void Synthesizer::setBalance(float b) {
-    balance_ = std::clamp(b, -1.0f, 1.0f);
+    mailbox_.setBalance(std::clamp(b, -1.0f, 1.0f));
+}
+
+void Synthesizer::resumeSchedule() { mailbox_.postBeats(BeatOverride{}); }
+
+void Synthesizer::pollParams() {
+    double seekSec;
+    if (mailbox_.takeSeek(seekSec)) seekElapsed(seekSec);
+
+    const MixParams target{mailbox_.volume(), mailbox_.balance()};
+    if (!paramsLive_) {
+        paramFrom_ = target;
+        paramTo_ = target;
+        paramRampLeft_ = 0;
+        paramsLive_ = true;
+    } else if (target != paramTo_) {
+        paramFrom_ = paramsAt(0);
+        paramTo_ = target;
+        paramRampLeft_ = paramRampFrames_;
+    }
+
+    if (beatRampEnd_ >= 0 && renderFrame_ >= beatRampEnd_) finishBeatRamp();
+    BeatOverride beats;
+    if (mailbox_.takeBeats(beats)) applyBeats(beats);
+}
+
+Synthesizer::MixParams Synthesizer::paramsAt(int64_t frames) const {
+    if (paramRampLeft_ <= frames) return paramTo_;
+    const float t =
+        static_cast<float>(paramRampFrames_ - paramRampLeft_ + frames) /
+        static_cast<float>(paramRampFrames_);
+    return {paramFrom_.volume + (paramTo_.volume - paramFrom_.volume) * t,
+            paramFrom_.balance + (paramTo_.balance - paramFrom_.balance) * t};
 }
 
-void Synthesizer::skewVoices(float periodElapsedSec) {
+void Synthesizer::applyBeats(const BeatOverride& beats) {
     if (program_.seq.empty()) return;
     const Period& period = program_.seq[currentPeriodIndex_];
     if (period.voices.empty()) return;
+    if (beats.kind == BeatOverride::Kind::Schedule) {
+        if (scheduled_) return;
+        reanchor(renderFrame_);
+        applySchedule(voices_, period, anchorFrame_);
+        scheduled_ = true;
+        beatRampEnd_ = -1;
+        return;
+    }
+    // 从当前节拍沿直线滑向目标，相位由锚点闭式求出，过渡全程连续
+    reanchor(renderFrame_);
+    const float frames = static_cast<float>(paramRampFrames_);
+    if (beats.kind == BeatOverride::Kind::All) {
+        voices_.glideAllBeats(beats.hz[0], frames);
+    } else {
+        for (uint32_t j = 0; j < beats.count; ++j) {
+            voices_.glideBeat(j, beats.hz[j], frames);
+        }
+    }
+    beatTarget_ = beats;
+    beatRampEnd_ = renderFrame_ + paramRampFrames_;
+    scheduled_ = false;
+    onTimeline_ = false;
+}
 
-    const int length = period.lengthSec;
-    if (length <= 0) return;
-
-    const float pos = periodElapsedSec;
-    const auto& v0 = period.voices[0];
-    const float ratio = (v0.freqEnd - v0.freqStart) / length;
-    const float res = ratio * pos + v0.freqStart;
-
-    freqs_.resize(period.voices.size());
-    for (size_t j = 0; j < period.voices.size(); ++j) {
-        freqs_[j] = res;
+void Synthesizer::finishBeatRamp() {
+    reanchor(beatRampEnd_);
+    if (beatTarget_.kind == BeatOverride::Kind::All) {
+        voices_.setAllBeats(beatTarget_.hz[0]);
+    } else {
+        for (uint32_t j = 0; j < beatTarget_.count; ++j) {
+            voices_.setBeat(j, beatTarget_.hz[j]);
+        }
     }
+    beatRampEnd_ = -1;
 }
 
 void Synthesizer::fillSamples(std::vector<int16_t>& outSamples) {
+    BINAURAL_TRACE_SCOPE("fillSamples");
     outSamples.resize(config_.bufferFrames * 2);
+    render(outSamples.data(), static_cast<size_t>(config_.bufferFrames));
+}
 
-    if (program_.seq.empty()) {
-        std::fill(outSamples.begin(), outSamples.end(), 0);
-        return;
-    }
+void Synthesizer::render(int16_t* out, size_t frames) {
+    RealtimeScope realtime;
+    renderInterleaved(out, frames);
+}
+
+void Synthesizer::render(float* out, size_t frames) {
+    RealtimeScope realtime;
+    renderInterleaved(out, frames);
+}
+
+void Synthesizer::skip(size_t frames) {
+    if (programFrames_ <= 0) return;
+    renderFrame_ += static_cast<int64_t>(frames);
+    paramRampLeft_ =
+        std::max<int64_t>(paramRampLeft_ - static_cast<int64_t>(frames), 0);
+    crossBoundaries();
+}
+
+void Synthesizer::seek(int periodIndex, uint64_t frame) {
+    if (program_.seq.empty()) return;
+    locate(periodIndex, static_cast<int64_t>(frame));
+    mailbox_.discardBeats();
+    paramsLive_ = false;
+    publishClock();
+}
+
+void Synthesizer::publishClock() {
+    shownPeriod_.store(clockPeriod_, std::memory_order_relaxed);
+    shownFrame_.store(periodFrame_, std::memory_order_relaxed);
+}
+
+void Synthesizer::locate(int periodIndex, int64_t frame) {
+    currentPeriodIndex_ = std::clamp(
+        periodIndex, 0, static_cast<int>(program_.seq.size()) - 1);
+    renderFrame_ = frame;
+    clockPeriod_ = currentPeriodIndex_;
+    clockLoop_ = loop_;
+    periodFrame_ = frame;
 
     const Period& period = program_.seq[currentPeriodIndex_];
-    if (period.voices.empty()) {
-        std::fill(outSamples.begin(), outSamples.end(), 0);
+    ensureStateSize();
+    loadEntryPhases(voices_, currentPeriodIndex_);
+    onTimeline_ = true;
+    anchorFrame_ = 0;
+    if (!period.voices.empty()) applySchedule(voices_, period, anchorFrame_);
+    scheduled_ = true;
+    beatRampEnd_ = -1;
+    voicesBlock_ = -1;
+    prepareTail();
+}
+
+void Synthesizer::seekProgram(uint64_t frame) {
+    if (timeline_.empty()) return;
+    int64_t f = static_cast<int64_t>(frame);
+    if (programFrames_ > 0) {
+        loop_ = frame / static_cast<uint64_t>(programFrames_);
+        f %= programFrames_;
+    }
+    // 零时长的 period 与下一个起点相同，取最后一个
+    const auto it = std::upper_bound(
+        timeline_.begin(), timeline_.end(), f,
+        [](int64_t v, const PeriodEntry& e) { return v < e.start; });
+    const int p = std::max(static_cast<int>(it - timeline_.begin()) - 1, 0);
+    seek(p, static_cast<uint64_t>(f - timeline_[p].start));
+}
+
+Synthesizer::Segment Synthesizer::segment(int periodIndex) const {
+    const size_t p = static_cast<size_t>(periodIndex);
+    if (p >= timeline_.size()) return {0, 0};
+    const int64_t end =
+        p + 1 < timeline_.size() ? timeline_[p + 1].start : programFrames_;
+    return {static_cast<uint64_t>(timeline_[p].start),
+            static_cast<uint64_t>(end)};
+}
+
+std::string Synthesizer::segmentKey(int periodIndex) const {
+    std::string key;
+    const size_t p = static_cast<size_t>(periodIndex);
+    if (p >= timeline_.size()) return key;
+    auto put = [&key](const auto& v) {
+        key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+    };
+    put(OUTPUT_VERSION);
+    put(config_.sampleRate);
+    put(config_.bufferFrames);
+    put(sinTable_.size());
+    put(kernels_->level);
+    put(config_.quality);
+    put(config_.oscillator);
+    put(config_.specializedMix);
+    put(crossfadeFrames_);
+    put(mailbox_.volume());
+    put(mailbox_.balance());
+
+    auto putPeriod = [&](size_t index) {
+        const Period& period = program_.seq[index];
+        put(period.lengthSec);
+        put(period.background);
+        put(period.backgroundVol);
+        put(period.voices.size());
+        for (size_t j = 0; j < period.voices.size(); ++j) {
+            const BinauralBeatVoice& v = period.voices[j];
+            put(v.freqStart);
+            put(v.freqEnd);
+            put(v.volume);
+            put(pitchOf(period, static_cast<int>(j)));
+            put(v.isochronic);
+        }
+        const PeriodEntry& e = timeline_[index];
+        const size_t phaseEnd =
+            index + 1 < timeline_.size() ? timeline_[index + 1].phaseOffset
+                                         : entryPhaseA_.size();
+        for (size_t i = e.phaseOffset; i < phaseEnd; ++i) {
+            put(entryPhaseA_[i]);
+            put(entryPhaseB_[i]);
+        }
+    };
+    putPeriod(p);
+    // 淡出的上一 period 从其起点按日程延续
+    if (crossfadeFrames_ > 0 && p > 0) putPeriod(p - 1);
+
+    // 噪声随机数以绝对帧为计数器，位置本身也是键的一部分
+    const PeriodEntry& e = timeline_[p];
+    const Segment seg = segment(periodIndex);
+    put(seg.begin);
+    put(seg.end);
+    put(e.pinkRunStart);
+    return key;
+}
+
+template <typename Sample>
+void Synthesizer::renderInterleaved(Sample* out, size_t frames) {
+    if (programFrames_ <= 0) {
+        std::fill(out, out + frames * 2, Sample{});
         return;
     }
 
     ensureStateSize();
+    crossBoundaries();
+    pollParams();
+
+    // 按 program 起点对齐的 bufferFrames 网格分块；从块中间开始时整组渲染
+    // 块前缀再丢弃开头，结果与从块首渲染一致（新 period 从块中间开始时同理）。
+    // period 切换点、参数过渡与交叉淡化的结束帧处切分，切分方式不影响输出。
+    // 块内已渲染的 voice 与粉红噪声保留到下次调用，短于一块的调用只取剩余帧
+    const int64_t blockFrames = static_cast<int64_t>(scratchL_.size());
+    while (frames > 0) {
+        const Period& period = program_.seq[currentPeriodIndex_];
+        const int64_t periodStart = timeline_[currentPeriodIndex_].start;
+        const int64_t frame = periodStart + renderFrame_;
+        const int64_t blockStart = frame - frame % blockFrames;
+        const int offset = static_cast<int>(frame - blockStart);
+        // voice 状态（锚点、period、交叉淡化）不变的范围；暂存区按它渲染，
+        // 同一块内之后更短的调用直接取用
+        int64_t stable = std::min(
+            blockFrames - offset,
+            periodFrames(period, config_.sampleRate) - renderFrame_);
+        if (beatRampEnd_ > renderFrame_)
+            stable = std::min(stable, beatRampEnd_ - renderFrame_);
+        const bool tail = tailPeriod_ >= 0 && renderFrame_ < tailFrames_;
+        if (tail) stable = std::min(stable, tailFrames_ - renderFrame_);
+        int64_t limit = std::min(static_cast<int64_t>(frames), stable);
+        if (paramRampLeft_ > 0) limit = std::min(limit, paramRampLeft_);
+        const int n = static_cast<int>(limit);
 
-    const int numFrames = config_.bufferFrames;
-    const float sampleRate = static_cast<float>(config_.sampleRate);
-    const int numVoices = static_cast<int>(period.voices.size());
-
-    float fade = 1.0f;
-    if (period.lengthSec >= FADE_INOUT_PERIOD) {
-        const float fadePeriod = std::min(FADE_INOUT_PERIOD / 2.0f,
-                                          period.lengthSec / 2.0f);
-        if (periodElapsedSec_ < fadePeriod) {
-            fade = FADE_MIN + (periodElapsedSec_ / fadePeriod) * (1.0f - FADE_MIN);
-        } else if (period.lengthSec - periodElapsedSec_ < fadePeriod) {
-            fade = FADE_MIN + ((period.lengthSec - periodElapsedSec_) / fadePeriod) *
-                                 (1.0f - FADE_MIN);
+        if (period.voices.empty()) {
+            // 没有 voice 的 period 静音，照常计时
+            std::fill(out, out + static_cast<size_t>(n) * 2, Sample{});
+        } else {
+            const int64_t blockFrame = blockStart - periodStart;
+            const float fade = fadeGain(period, blockFrame);
+            // 交叉淡化就地混入暂存区，不能再次取用
+            if (tail || voicesBlock_ != blockStart ||
+                voicesFrames_ < offset + n) {
+                BINAURAL_TRACE_SCOPE("oscillators");
+                const int voiceFrames = static_cast<int>(std::min<int64_t>(
+                    blockFrames, (offset + (tail ? n : stable) +
+                                  KERNEL_GROUP - 1) /
+                                     KERNEL_GROUP * KERNEL_GROUP));
+                renderVoices(blockFrame, voiceFrames, fade);
+                voicesBlock_ = blockStart;
+                voicesFrames_ = voiceFrames;
+                if (tail) {
+                    mixTail(blockFrame, voiceFrames, offset, n);
+                    voicesBlock_ = -1;
+                }
+            }
+            if (config_.specializedMix) {
+                mixBlock(period, blockStart, offset, n, fade,
+                         tail || voices_.audibleCount() > 0, out);
+            } else {
+                mixBlockGeneric(period, blockStart, offset, n, fade, out);
+            }
         }
+        out += static_cast<size_t>(n) * 2;
+        frames -= static_cast<size_t>(n);
+        renderFrame_ += n;
+        paramRampLeft_ = std::max<int64_t>(paramRampLeft_ - n, 0);
+        if (renderFrame_ == beatRampEnd_) finishBeatRamp();
+        crossBoundaries();
     }
+}
 
-    std::vector<float> ws(numFrames * 2, 0.f);
+// 按整数帧计算，float 秒数在数小时的 period 里只剩毫秒级分辨率
+float Synthesizer::fadeGain(const Period& period, int64_t frame) const {
+    if (period.lengthSec < FADE_INOUT_PERIOD) return 1.0f;
+    const int64_t length = periodFrames(period, config_.sampleRate);
+    const int64_t fadeFrames = std::min<int64_t>(
+        std::llround(FADE_INOUT_PERIOD / 2.0 * config_.sampleRate),
+        length / 2);
+    const int64_t edge =
+        std::min(std::max<int64_t>(frame, 0), length - frame);
+    if (edge >= fadeFrames) return 1.0f;
+    return FADE_MIN + static_cast<float>(static_cast<double>(edge) /
+                                         static_cast<double>(fadeFrames)) *
+                          (1.0f - FADE_MIN);
+}
 
-    const float phaseStepScale = 1.0f / sampleRate;
-    for (int j = 0; j < numVoices; ++j) {
-        const float baseFreq = pitchs_[j];
-        const float beatFreq = freqs_[j];
-        const float vol = vols_[j] * fade * volumeMultiplier_;
+void Synthesizer::renderVoices(int64_t blockFrame, int numFrames, float fade) {
+    // 全部静音时特化混音不读暂存区；交叉淡化时由 mixTail 清零
+    if (voices_.audibleCount() == 0 && config_.specializedMix) return;
+    // 音量倍率在混音时逐样本乘上，可平滑过渡
+    const float gain = fade;
+    const int64_t d0 = blockFrame - anchorFrame_;
+    std::fill(scratchL_.begin(), scratchL_.begin() + numFrames, 0.f);
+    std::fill(scratchR_.begin(), scratchR_.begin() + numFrames, 0.f);
+    oscillate(voices_, static_cast<double>(d0), numFrames, gain,
+              scratchL_.data(), scratchR_.data());
+}
 
-        float phaseL = phasesL_[j];
-        float phaseR = phasesR_[j];
-        float phaseIso = phasesIso_[j];
+// 上一 period 的 voice 以其末尾的 fade 延续，按两边 voice 数归一化的比例
+// 折算到当前 period 的混音增益下；权重 cos/sin 使两路不相关时总功率不变
+void Synthesizer::mixTail(int64_t blockFrame, int voiceFrames, int offset,
+                          int numFrames) {
+    const Period& prev = program_.seq[tailPeriod_];
+    const Period& period = program_.seq[currentPeriodIndex_];
+    const int64_t prevLength = periodFrames(prev, config_.sampleRate);
+    if (voices_.audibleCount() == 0 && config_.specializedMix) {
+        std::fill(scratchL_.begin(), scratchL_.begin() + voiceFrames, 0.f);
+        std::fill(scratchR_.begin(), scratchR_.begin() + voiceFrames, 0.f);
+    }
+    std::fill(tailL_.begin(), tailL_.begin() + voiceFrames, 0.f);
+    std::fill(tailR_.begin(), tailR_.begin() + voiceFrames, 0.f);
+    if (tailVoices_.audibleCount() > 0) {
+        const float gain = fadeGain(prev, prevLength) *
+                           static_cast<float>(period.voices.size()) /
+                           static_cast<float>(prev.voices.size());
+        oscillate(tailVoices_, static_cast<double>(prevLength + blockFrame),
+                  voiceFrames, gain, tailL_.data(), tailR_.data());
+    }
 
-        if (isochronic_[j]) {
-            // Isochronic: same frequency in both ears, pulsed at beatFreq.
-            // Works without headphones (unlike binaural).
-            const float incCarrier = baseFreq * phaseStepScale;
-            const float incIso = beatFreq * phaseStepScale;
-            for (int i = 0; i < numFrames * 2; i += 2) {
-                float gain = 0.f;
-                if (phaseIso < 0.5f) {
-                    gain = std::cos(phaseIso * 3.14159265f);
-                }
-                const float s = std::sin(TWO_PI * phaseL) * vol * gain;
-                ws[i] += s;
-                ws[i + 1] += s;
-                phaseL += incCarrier;
-                phaseR = phaseL;
-                if (phaseL >= 1.0f) phaseL -= 1.0f;
-                if (phaseR >= 1.0f) phaseR -= 1.0f;
-                phaseIso += incIso;
-                if (phaseIso >= 1.0f) phaseIso -= 1.0f;
-                if (phaseIso < 0.0f) phaseIso += 1.0f;
-            }
+    constexpr double HALF_PI = 1.57079632679489661923;
+    const double step = HALF_PI / static_cast<double>(tailFrames_);
+    for (int f = offset; f < offset + numFrames; ++f) {
+        const double x = static_cast<double>(blockFrame + f) * step;
+        const float in = static_cast<float>(std::sin(x));
+        const float outGain = static_cast<float>(std::cos(x));
+        scratchL_[f] = scratchL_[f] * in + tailL_[f] * outGain;
+        scratchR_[f] = scratchR_[f] * in + tailR_[f] * outGain;
+    }
+}
+
+void Synthesizer::oscillate(const VoiceBank& bank, double d0, int numFrames,
+                            float gain, float* wsL, float* wsR) {
+    // 后端在块外选定一次，组内循环只剩内核调用
+    switch (config_.oscillator) {
+        case OscillatorBackend::Table:
+            renderGroups(
+                bank, d0, numFrames, gain, wsL, wsR,
+                [this](auto... args) {
+                    kernels::binauralTable(sinTable_, args...);
+                },
+                [this](auto... args) {
+                    kernels::isochronicTable(sinTable_, args...);
+                });
+            break;
+        case OscillatorBackend::FixedPoint:
+            renderGroups(
+                bank, d0, numFrames, gain, wsL, wsR,
+                [this](auto... args) {
+                    kernels::binauralFixedPoint(sinTable_, args...);
+                },
+                [this](auto... args) {
+                    kernels::isochronicFixedPoint(sinTable_, args...);
+                });
+            break;
+        case OscillatorBackend::Libm:
+            renderGroups(bank, d0, numFrames, gain, wsL, wsR,
+                         kernels::binauralLibm, kernels::isochronicLibm);
+            break;
+        default:
+            renderGroups(bank, d0, numFrames, gain, wsL, wsR,
+                         kernels_->binaural, kernels_->isochronic);
+            break;
+    }
+}
+
+template <typename BinauralOp, typename IsochronicOp>
+void Synthesizer::renderGroups(const VoiceBank& bank, double d0,
+                               int numFrames, float gain, float* wsL,
+                               float* wsR, BinauralOp&& binaural,
+                               IsochronicOp&& isochronic) {
+    const float* volume = bank.volume.data();
+    const double* phaseA = bank.phaseA.data();
+    const double* phaseB = bank.phaseB.data();
+    const double sampleRate = config_.sampleRate;
+    const size_t numBinaural = bank.binauralCount();
+    const size_t numVoices = bank.audibleCount();
+
+    for (size_t s = 0; s < numBinaural; ++s) {
+        const VoiceBank::Oscillators osc = bank.oscillators(s);
+        const phase::Ramp l =
+            phase::ramp(phaseA[s], osc.hzA, osc.slopeA, d0, sampleRate);
+        const phase::Ramp r =
+            phase::ramp(phaseB[s], osc.hzB, osc.slopeB, d0, sampleRate);
+        binaural(wsL, wsR, numFrames, l, r, volume[s] * gain);
+    }
+
+    // Isochronic: same frequency in both ears, pulsed at beatFreq.
+    // Works without headphones (unlike binaural).
+    for (size_t s = numBinaural; s < numVoices; ++s) {
+        const VoiceBank::Oscillators osc = bank.oscillators(s);
+        const phase::Ramp carrier =
+            phase::ramp(phaseA[s], osc.hzA, osc.slopeA, d0, sampleRate);
+        const phase::Ramp iso =
+            phase::ramp(phaseB[s], osc.hzB, osc.slopeB, d0, sampleRate);
+        isochronic(wsL, wsR, numFrames, carrier, iso, volume[s] * gain);
+    }
+}
+
+// 滤波状态依赖历史：顺序渲染时直接接续；块内再次渲染时取块首快照；
+// 其余情况（seek、噪声中断后恢复）清零后从至少 PINK_SETTLE_FRAMES 帧前的
+// 块首补算，不早于所在连续粉红噪声段的起算帧，与连续渲染的状态逐位一致
+void Synthesizer::preparePink(int64_t blockStart) {
+    if (pinkFrame_ != blockStart) {
+        if (pinkBlockFrame_ == blockStart) {
+            pinkNoise_ = pinkBlock_;
         } else {
-            const float incL = (baseFreq + beatFreq) * phaseStepScale;
-            const float incR = baseFreq * phaseStepScale;
-            for (int i = 0; i < numFrames * 2; i += 2) {
-                ws[i] += std::sin(TWO_PI * phaseL) * vol;
-                ws[i + 1] += std::sin(TWO_PI * phaseR) * vol;
-                phaseL += incL;
-                phaseR += incR;
-                if (phaseL >= 1.0f) phaseL -= 1.0f;
-                if (phaseR >= 1.0f) phaseR -= 1.0f;
+            const int64_t blockFrames = static_cast<int64_t>(scratchNoise_.size());
+            const int64_t from = std::min(
+                blockStart,
+                std::max(blockStart -
+                             pinkSettleBlocks(blockFrames) * blockFrames,
+                         timeline_[currentPeriodIndex_].pinkRunStart));
+            pinkNoise_.clear();
+            pinkNoise_.seek(static_cast<uint64_t>(from));
+            for (int64_t f = from; f < blockStart; f += blockFrames) {
+                pinkNoise_.generate(scratchNoise_.data(),
+                                    static_cast<size_t>(blockFrames));
             }
         }
-        phasesL_[j] = phaseL;
-        phasesR_[j] = phaseR;
-        phasesIso_[j] = phaseIso;
-    }
-
-    const float multL = 1.0f - std::max(0.0f, balance_);
-    const float multR = 1.0f - std::max(0.0f, -balance_);
-    const float bgVol = period.backgroundVol * fade * volumeMultiplier_ * 0.5f;
-    const bool usePink = (period.background == Period::Background::PinkNoise);
-    const bool useWhite = (period.background == Period::Background::WhiteNoise);
-
-    for (int i = 0; i < numFrames * 2; i += 2) {
-        float valL = ws[i] * 32767.0f / numVoices * multL;
-        float valR = ws[i + 1] * 32767.0f / numVoices * multR;
-        if (bgVol > 0.f) {
-            if (usePink) {
-                const float p = pinkNoise_.tick();
-                valL += p * bgVol * 32767.0f * multL;
-                valR += p * bgVol * 32767.0f * multR;
-            } else if (useWhite) {
-                const float w = whiteNoise(whiteNoiseSeed_);
-                valL += w * bgVol * 32767.0f * multL;
-                valR += w * bgVol * 32767.0f * multR;
-            }
+    }
+    pinkBlock_ = pinkNoise_;
+    pinkBlockFrame_ = blockStart;
+}
+
+template <typename Sample>
+void Synthesizer::mixBlock(const Period& period, int64_t blockStart,
+                           int offset, int numFrames, float fade,
+                           bool hasVoices, Sample* out) {
+    const MixParams p0 = paramsAt(0);
+    const MixGains gains = mixGains(period, fade, p0.volume, p0.balance);
+    const bool ramped = paramRampLeft_ > 0;
+    MixGains steps{};
+    bool balanced = gains.balanced();
+    bool audibleNoise = gains.noiseL > 0.f || gains.noiseR > 0.f;
+    if (ramped) {
+        const MixParams p1 = paramsAt(numFrames);
+        const MixGains end = mixGains(period, fade, p1.volume, p1.balance);
+        steps = gainSteps(gains, end, numFrames);
+        balanced = balanced && end.balanced();
+        audibleNoise = audibleNoise || end.noiseL > 0.f || end.noiseR > 0.f;
+    }
+    // 粉红噪声整块生成（分段方式影响 float 舍入），同一块内再次调用时直接
+    // 取用；白噪声只生成需要的部分
+    if (pinkActive(period)) {
+        if (noiseBlock_ != blockStart) {
+            BINAURAL_TRACE_SCOPE("noise");
+            preparePink(blockStart);
+            pinkNoise_.generate(scratchNoise_.data(), scratchNoise_.size());
+            pinkFrame_ =
+                blockStart + static_cast<int64_t>(scratchNoise_.size());
+            noiseBlock_ = blockStart;
         }
-        outSamples[i] = static_cast<int16_t>(
-            std::clamp(valL, -32768.0f, 32767.0f));
-        outSamples[i + 1] = static_cast<int16_t>(
-            std::clamp(valR, -32768.0f, 32767.0f));
+    } else if (noiseActive(period)) {
+        BINAURAL_TRACE_SCOPE("noise");
+        whiteNoise_.seek(static_cast<uint64_t>(blockStart + offset));
+        whiteNoise_.generate(scratchNoise_.data() + offset,
+                             static_cast<size_t>(numFrames));
+        noiseBlock_ = -1;
     }
+    const bool hasNoise = noiseActive(period) && audibleNoise;
+    const MixFn<Sample> mix =
+        ramped ? selectMixKernel<Sample, true>(hasVoices, hasNoise, balanced)
+               : selectMixKernel<Sample, false>(hasVoices, hasNoise, balanced);
+    // 样本格式转换（int16 饱和）与混音在同一个循环里完成
+    BINAURAL_TRACE_SCOPE("mix + convert");
+    mix(scratchL_.data() + offset, scratchR_.data() + offset,
+        scratchNoise_.data() + offset, numFrames, gains, steps, out);
 }
 
-void Synthesizer::advanceTime(float sec) {
-    periodElapsedSec_ += sec;
-    if (program_.seq.empty()) return;
+template <typename Sample>
+void Synthesizer::mixBlockGeneric(const Period& period, int64_t blockStart,
+                                  int offset, int numFrames, float fade,
+                                  Sample* out) {
+    // 噪声逐样本生成，与混音、格式转换在同一个循环里
+    BINAURAL_TRACE_SCOPE("noise + mix + convert");
+    const float* wsL = scratchL_.data() + offset;
+    const float* wsR = scratchR_.data() + offset;
+    const MixParams p0 = paramsAt(0);
+    const MixParams p1 = paramsAt(numFrames);
+    const MixGains g = mixGains(period, fade, p0.volume, p0.balance);
+    const MixGains step = gainSteps(
+        g, mixGains(period, fade, p1.volume, p1.balance), numFrames);
+    const bool usePink = pinkActive(period);
+    const bool useWhite = !usePink && noiseActive(period);
+    if (usePink) {
+        // 接着上次调用的位置时滤波状态已在 offset 处
+        if (offset == 0 || pinkFrame_ != blockStart + offset) {
+            preparePink(blockStart);
+            for (int f = 0; f < offset; ++f) pinkNoise_.tick();
+        }
+        pinkFrame_ = blockStart + offset + numFrames;
+    } else if (useWhite) {
+        whiteNoise_.seek(static_cast<uint64_t>(blockStart + offset));
+    }
 
-    Period& period = program_.seq[currentPeriodIndex_];
-    if (periodElapsedSec_ >= period.lengthSec) {
-        periodElapsedSec_ -= period.lengthSec;
-        currentPeriodIndex_ = (currentPeriodIndex_ + 1) % program_.seq.size();
-        if (currentPeriodIndex_ == 0 && program_.seq.size() > 1) {
-            periodElapsedSec_ = 0.f;
+    for (int f = 0; f < numFrames; ++f) {
+        const float t = static_cast<float>(f);
+        float valL = wsL[f] * (g.voiceL + step.voiceL * t);
+        float valR = wsR[f] * (g.voiceR + step.voiceR * t);
+        if (usePink || useWhite) {
+            const float n = usePink ? pinkNoise_.tick() : whiteNoise_.tick();
+            valL += n * (g.noiseL + step.noiseL * t);
+            valR += n * (g.noiseR + step.noiseR * t);
         }
+        out[f * 2] = toSample<Sample>(valL);
+        out[f * 2 + 1] = toSample<Sample>(valR);
     }
 }
 
-void Synthesizer::setPeriodElapsedSec(float sec) {
+uint64_t Synthesizer::programFrame() const {
+    if (timeline_.empty()) return 0;
+    return static_cast<uint64_t>(timeline_[clockPeriod_].start + periodFrame_);
+}
+
+void Synthesizer::advanceFrames(uint64_t frames) {
+    if (programFrames_ <= 0) return;
+    // 一次跨越多轮 program 时先取模，之后的循环只走一轮内的 period
+    clockLoop_ += frames / static_cast<uint64_t>(programFrames_);
+    periodFrame_ += static_cast<int64_t>(
+        frames % static_cast<uint64_t>(programFrames_));
+    while (periodFrame_ >=
+           periodFrames(program_.seq[clockPeriod_], config_.sampleRate)) {
+        periodFrame_ -=
+            periodFrames(program_.seq[clockPeriod_], config_.sampleRate);
+        clockPeriod_ = (clockPeriod_ + 1) % static_cast<int>(program_.seq.size());
+        if (clockPeriod_ == 0) ++clockLoop_;
+    }
+    // 通常 render 已逐样本走到时钟位置（含其间的 period 切换）。
+    // 只推进时钟而未渲染时：同一轮同一 period 内直接移动，否则按规范
+    // 时间线定位到时钟所在轮次
+    if (clockLoop_ == loop_ && clockPeriod_ == currentPeriodIndex_) {
+        renderFrame_ = periodFrame_;
+    } else {
+        loop_ = clockLoop_;
+        locate(clockPeriod_, periodFrame_);
+    }
+    publishClock();
+}
+
+void Synthesizer::setPeriodElapsedSec(double sec) { mailbox_.postSeek(sec); }
+
+void Synthesizer::seekElapsed(double sec) {
     if (program_.seq.empty()) return;
-    const Period& period = program_.seq[currentPeriodIndex_];
-    periodElapsedSec_ =
-        std::clamp(sec, 0.f, static_cast<float>(period.lengthSec));
-    skewVoices(periodElapsedSec_);
+    const Period& period = program_.seq[clockPeriod_];
+    const double clamped =
+        std::clamp(sec, 0.0, std::max(period.lengthSec, 0.0));
+    seek(clockPeriod_,
+         static_cast<uint64_t>(std::llround(clamped * config_.sampleRate)));
 }
 
 float Synthesizer::voicetoPitch(int voiceIndex) const {
@@ -211,46 +857,243 @@ float Synthesizer::voicetoPitch(int voiceIndex) const {
     }
 }
 
+float Synthesizer::pitchOf(const Period& period, int voice) const {
+    return period.voices[voice].pitch < 0 ? voicetoPitch(voice)
+                                          : period.voices[voice].pitch;
+}
+
 const Period* Synthesizer::currentPeriod() const {
     if (program_.seq.empty()) return nullptr;
-    if (currentPeriodIndex_ < 0 ||
-        static_cast<size_t>(currentPeriodIndex_) >= program_.seq.size())
+    if (clockPeriod_ < 0 ||
+        static_cast<size_t>(clockPeriod_) >= program_.seq.size())
         return nullptr;
-    return &program_.seq[currentPeriodIndex_];
+    return &program_.seq[clockPeriod_];
 }
 
-void Synthesizer::ensureStateSize() {
-    if (program_.seq.empty()) return;
-    const Period& period = program_.seq[currentPeriodIndex_];
-    const size_t n = period.voices.size();
+// 规范时间线：period 按样本数首尾相接，进入时的相位由上一 period 的锚点按
+// 与 enterNextPeriod 相同的运算推进得到
+void Synthesizer::buildTimeline(PreparedProgram& out) const {
+    const Program& program = out.program;
+    if (program.seq.empty()) return;
+
+    const int64_t blockFrames = static_cast<int64_t>(scratchL_.size());
+    size_t maxVoices = 0;
+    VoiceBank bank;
+    int64_t start = 0;
+    for (size_t p = 0; p < program.seq.size(); ++p) {
+        const Period& period = program.seq[p];
+        if (p > 0) {
+            const int64_t length =
+                periodFrames(program.seq[p - 1], config_.sampleRate);
+            start += length;
+            bank.reanchor(static_cast<double>(length), config_.sampleRate);
+        }
+        bank.rebuild(period, [this, &period](int j) {
+            return pitchOf(period, j);
+        });
+        if (!period.voices.empty()) applySchedule(bank, period, 0);
+        maxVoices = std::max(maxVoices, period.voices.size());
 
-    if (freqs_.size() != n) {
-        freqs_.resize(n);
-        for (size_t j = 0; j < n; ++j) {
-            freqs_[j] = period.voices[j].freqStart;
+        // 粉红噪声整块生成，滤波起算帧落在网格上
+        int64_t pinkRunStart = 0;
+        if (p > 0 && pinkActive(program.seq[p - 1]))
+            pinkRunStart = out.timeline.back().pinkRunStart;
+        else
+            pinkRunStart = std::max<int64_t>(
+                start - start % blockFrames -
+                    pinkSettleBlocks(blockFrames) * blockFrames,
+                0);
+        out.timeline.push_back({start, pinkRunStart, out.entryPhaseA.size()});
+        for (size_t j = 0; j < bank.size(); ++j) {
+            out.entryPhaseA.push_back(bank.phaseA[bank.slotOf(j)]);
+            out.entryPhaseB.push_back(bank.phaseB[bank.slotOf(j)]);
         }
     }
-    if (vols_.size() != n) vols_.resize(n);
-    for (size_t j = 0; j < n; ++j) {
-        vols_[j] = period.voices[j].volume;
+    out.programFrames =
+        start + periodFrames(program.seq.back(), config_.sampleRate);
+
+    size_t carried = SIZE_MAX;
+    for (const Period& period : program.seq)
+        carried = std::min(carried, period.voices.size());
+    LoopPhases& loop = out.loopPhases;
+    loop.baseA.resize(out.entryPhaseA.size());
+    loop.baseB.resize(out.entryPhaseB.size());
+    loop.stepA.resize(carried);
+    loop.stepB.resize(carried);
+    buildLoopPhases(program, out.timeline, out.entryPhaseA, out.entryPhaseB,
+                    bank, loop);
+    out.voices.reserve(maxVoices);
+    if (crossfadeFrames_ > 0) out.tailVoices.reserve(maxVoices);
+}
+
+void Synthesizer::rebaseTimeline(int periodIndex, int64_t frame,
+                                 const VoiceBank& live) {
+    auto writeEntry = [this](int p) {
+        const size_t offset = timeline_[p].phaseOffset;
+        for (size_t j = 0; j < voices_.size(); ++j) {
+            entryPhaseA_[offset + j] = voices_.phaseA[voices_.slotOf(j)];
+            entryPhaseB_[offset + j] = voices_.phaseB[voices_.slotOf(j)];
+        }
+    };
+    const Period& period = program_.seq[periodIndex];
+    voices_.rebuild(period, [this, &period](int j) {
+        return pitchOf(period, j);
+    });
+    if (!period.voices.empty()) {
+        // 新日程下从第 frame 帧倒推回 period 起点
+        applySchedule(voices_, period, frame);
+        for (size_t s = 0; s < voices_.size(); ++s) {
+            const size_t slot = live.slotOf(voices_.voiceOf(s));
+            voices_.phaseA[s] = live.phaseA[slot];
+            voices_.phaseB[s] = live.phaseB[slot];
+        }
+        voices_.reanchor(-static_cast<double>(frame), config_.sampleRate);
+        applySchedule(voices_, period, 0);
     }
-    if (pitchs_.size() != n) pitchs_.resize(n);
-    for (size_t j = 0; j < n; ++j) {
-        pitchs_[j] = period.voices[j].pitch < 0
-                        ? voicetoPitch(static_cast<int>(j))
-                        : period.voices[j].pitch;
+    writeEntry(periodIndex);
+    for (size_t p = static_cast<size_t>(periodIndex) + 1;
+         p < program_.seq.size(); ++p) {
+        const Period& next = program_.seq[p];
+        voices_.reanchor(
+            static_cast<double>(periodFrames(program_.seq[p - 1],
+                                             config_.sampleRate)),
+            config_.sampleRate);
+        voices_.rebuild(next, [this, &next](int j) {
+            return pitchOf(next, j);
+        });
+        if (!next.voices.empty()) applySchedule(voices_, next, 0);
+        writeEntry(static_cast<int>(p));
     }
-    if (isochronic_.size() != n) {
-        isochronic_.resize(n);
-        for (size_t j = 0; j < n; ++j) {
-            isochronic_[j] = period.voices[j].isochronic;
+    buildLoopPhases(program_, timeline_, entryPhaseA_, entryPhaseB_, voices_,
+                    loopPhases_);
+}
+
+// 每轮都延续的 voice 在一轮中只被逐 period 推进，整轮相当于平移固定相位，
+// 取最后一个 period 相邻两轮进入相位之差；第三轮起按倍数推算，seek 与
+// 连续播放用同一式子，因此逐位一致
+void Synthesizer::buildLoopPhases(const Program& program,
+                                  const std::vector<PeriodEntry>& timeline,
+                                  const std::vector<double>& entryA,
+                                  const std::vector<double>& entryB,
+                                  VoiceBank& bank, LoopPhases& loop) const {
+    const size_t last = program.seq.size() - 1;
+    for (size_t p = 0; p <= last; ++p) {
+        const Period& period = program.seq[p];
+        bank.reanchor(
+            static_cast<double>(periodFrames(program.seq[p == 0 ? last : p - 1],
+                                             config_.sampleRate)),
+            config_.sampleRate);
+        bank.rebuild(period, [this, &period](int j) {
+            return pitchOf(period, j);
+        });
+        if (!period.voices.empty()) applySchedule(bank, period, 0);
+        const size_t offset = timeline[p].phaseOffset;
+        for (size_t j = 0; j < bank.size(); ++j) {
+            loop.baseA[offset + j] = bank.phaseA[bank.slotOf(j)];
+            loop.baseB[offset + j] = bank.phaseB[bank.slotOf(j)];
         }
     }
-    if (phasesL_.size() != n) {
-        phasesL_.resize(n, 0.f);
-        phasesR_.resize(n, 0.f);
-        phasesIso_.resize(n, 0.f);
+    const size_t offset = timeline[last].phaseOffset;
+    for (size_t j = 0; j < loop.stepA.size(); ++j) {
+        loop.stepA[j] = phase::wrap(loop.baseA[offset + j] - entryA[offset + j]);
+        loop.stepB[j] = phase::wrap(loop.baseB[offset + j] - entryB[offset + j]);
     }
 }
 
+void Synthesizer::loadEntryPhases(VoiceBank& bank, int periodIndex) const {
+    const size_t offset = timeline_[periodIndex].phaseOffset;
+    const double rounds = loop_ > 0 ? static_cast<double>(loop_ - 1) : 0.0;
+    for (size_t s = 0; s < bank.size(); ++s) {
+        const size_t j = bank.voiceOf(s);
+        if (loop_ == 0) {
+            bank.phaseA[s] = entryPhaseA_[offset + j];
+            bank.phaseB[s] = entryPhaseB_[offset + j];
+        } else if (j < loopPhases_.stepA.size()) {
+            bank.phaseA[s] = phase::wrap(loopPhases_.baseA[offset + j] +
+                                         rounds * loopPhases_.stepA[j]);
+            bank.phaseB[s] = phase::wrap(loopPhases_.baseB[offset + j] +
+                                         rounds * loopPhases_.stepB[j]);
+        } else {
+            bank.phaseA[s] = loopPhases_.baseA[offset + j];
+            bank.phaseB[s] = loopPhases_.baseB[offset + j];
+        }
+    }
+}
+
+void Synthesizer::ensureStateSize() {
+    if (program_.seq.empty() || voicesPeriodIndex_ == currentPeriodIndex_)
+        return;
+    const Period& period = program_.seq[currentPeriodIndex_];
+    voices_.rebuild(period, [this, &period](int j) {
+        return pitchOf(period, j);
+    });
+    voicesPeriodIndex_ = currentPeriodIndex_;
+}
+
+void Synthesizer::applySchedule(VoiceBank& bank, const Period& period,
+                                int64_t frame) const {
+    for (size_t s = 0; s < bank.size(); ++s) {
+        const Schedule sched =
+            scheduleOf(period, bank.voiceOf(s), config_.sampleRate);
+        bank.beat[s] = static_cast<double>(sched.beat) +
+                       sched.slope * static_cast<double>(frame);
+        bank.beatSlope[s] = sched.slope;
+    }
+}
+
+void Synthesizer::reanchor(int64_t frame) {
+    voices_.reanchor(static_cast<double>(frame - anchorFrame_),
+                     config_.sampleRate);
+    anchorFrame_ = frame;
+    voicesBlock_ = -1;
+}
+
+void Synthesizer::crossBoundaries() {
+    if (programFrames_ <= 0) return;
+    while (renderFrame_ >= periodFrames(program_.seq[currentPeriodIndex_],
+                                        config_.sampleRate)) {
+        enterNextPeriod();
+    }
+}
+
+// 切换时刻的相位带入新 period，未被覆盖时与 buildTimeline 的模拟逐位一致
+void Synthesizer::enterNextPeriod() {
+    const int64_t length = periodFrames(program_.seq[currentPeriodIndex_],
+                                        config_.sampleRate);
+    ensureStateSize();
+    reanchor(length);
+    renderFrame_ -= length;
+    currentPeriodIndex_ =
+        (currentPeriodIndex_ + 1) % static_cast<int>(program_.seq.size());
+    if (currentPeriodIndex_ == 0) ++loop_;
+    anchorFrame_ = 0;
+    ensureStateSize();
+    // 第一轮内与带入的相位逐位相同；之后各轮由此与 seek 逐位一致
+    if (onTimeline_) loadEntryPhases(voices_, currentPeriodIndex_);
+    const Period& next = program_.seq[currentPeriodIndex_];
+    if (!next.voices.empty()) applySchedule(voices_, next, anchorFrame_);
+    scheduled_ = true;
+    beatRampEnd_ = -1;
+    prepareTail();
+}
+
+// 淡出的 voice 总按上一 period 的日程从其起点推算，不带 setFreqs 覆盖，
+// 因此 seek 到淡化区间内与连续渲染逐位一致
+void Synthesizer::prepareTail() {
+    tailPeriod_ = -1;
+    if (crossfadeFrames_ <= 0 || currentPeriodIndex_ == 0) return;
+    const int prevIndex = currentPeriodIndex_ - 1;
+    const Period& prev = program_.seq[prevIndex];
+    if (prev.voices.empty()) return;
+    tailVoices_.rebuild(prev, [this, &prev](int j) {
+        return pitchOf(prev, j);
+    });
+    loadEntryPhases(tailVoices_, prevIndex);
+    applySchedule(tailVoices_, prev, 0);
+    tailPeriod_ = prevIndex;
+    tailFrames_ = std::min(
+        crossfadeFrames_,
+        periodFrames(program_.seq[currentPeriodIndex_], config_.sampleRate));
+}
+
 }  // namespace binaural
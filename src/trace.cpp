@@ -0,0 +1,238 @@
+#include "binaural/trace.hpp"
+#include <chrono>
+
+#if defined(BINAURAL_TRACE)
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace binaural {
+namespace trace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+#if defined(BINAURAL_TRACE)
+
+namespace {
+
+// 线程名表的大小；按线程号取模，被更晚的线程占用后旧线程导出时不带名字
+constexpr size_t NAME_SLOTS = 256;
+
+struct Event {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> begin{0};
+    std::atomic<uint64_t> end{0};
+    std::atomic<uint32_t> tid{0};
+};
+
+// 单写者环形缓冲。写者先推进 claimed 再覆写槽位、最后推进 committed；
+// 读者复制后重读 claimed，丢弃复制期间可能被覆写的槽位（seqlock 式校验）。
+// owner 为借用线程的线程号，0 为空闲。归还后的线程接着写同一个环，
+// 事件各自带线程号
+struct Ring {
+    std::atomic<uint32_t> owner{0};
+    std::atomic<uint64_t> claimed{0};
+    std::atomic<uint64_t> committed{0};
+    Event events[EVENTS_PER_THREAD];
+};
+
+struct ThreadName {
+    std::atomic<uint32_t> tid{0};
+    std::atomic<const char*> name{nullptr};
+};
+
+// 静态池：线程首次记录时借一个空闲的环，releaseThread 时归还；
+// 没有空闲环时不记录，下次记录再试
+Ring rings[MAX_THREADS];
+ThreadName names[NAME_SLOTS];
+std::atomic<uint32_t> nextTid{0};
+
+// 可平凡析构：带析构函数的 thread_local 在线程首次访问时要登记析构
+// （__cxa_thread_atexit 会分配），音频回调里的第一次记录就不再实时安全。
+// 环因此不随线程退出自动归还。ring 被另一处归还后 owner 不再是 tid，
+// 下次记录重新借用
+struct ThreadSlot {
+    Ring* ring;
+    uint32_t tid;
+};
+static_assert(std::is_trivially_destructible_v<ThreadSlot>);
+thread_local ThreadSlot threadSlot{nullptr, 0};
+
+ThreadSlot* currentSlot() {
+    ThreadSlot& slot = threadSlot;
+    if (slot.ring &&
+        slot.ring->owner.load(std::memory_order_relaxed) == slot.tid)
+        return &slot;
+    slot.ring = nullptr;
+    if (slot.tid == 0)
+        slot.tid = nextTid.fetch_add(1, std::memory_order_relaxed) + 1;
+    for (Ring& ring : rings) {
+        uint32_t expected = 0;
+        if (ring.owner.load(std::memory_order_relaxed) == 0 &&
+            ring.owner.compare_exchange_strong(expected, slot.tid,
+                                               std::memory_order_acquire)) {
+            slot.ring = &ring;
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+const char* nameOf(uint32_t tid) {
+    const ThreadName& entry = names[tid % NAME_SLOTS];
+    if (entry.tid.load(std::memory_order_acquire) != tid) return nullptr;
+    const char* name = entry.name.load(std::memory_order_acquire);
+    return entry.tid.load(std::memory_order_acquire) == tid ? name : nullptr;
+}
+
+struct Copied {
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+    uint32_t tid;
+};
+
+}  // namespace
+
+void setThreadName(const char* name) {
+    ThreadSlot* slot = currentSlot();
+    if (!slot) return;
+    ThreadName& entry = names[slot->tid % NAME_SLOTS];
+    if (entry.tid.load(std::memory_order_relaxed) == slot->tid &&
+        entry.name.load(std::memory_order_relaxed) == name)
+        return;
+    entry.tid.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.name.store(name, std::memory_order_relaxed);
+    entry.tid.store(slot->tid, std::memory_order_release);
+}
+
+uint32_t threadId() {
+    const ThreadSlot& slot = threadSlot;
+    return slot.ring ? slot.tid : 0;
+}
+
+void releaseThread(uint32_t tid) {
+    if (tid == 0) return;
+    for (Ring& ring : rings) {
+        uint32_t expected = tid;
+        if (ring.owner.compare_exchange_strong(expected, 0,
+                                               std::memory_order_release))
+            return;
+    }
+}
+
+void releaseThread() {
+    ThreadSlot& slot = threadSlot;
+    if (slot.ring) releaseThread(slot.tid);
+    slot.ring = nullptr;
+}
+
+void record(const char* name, uint64_t beginNs, uint64_t endNs) {
+    ThreadSlot* slot = currentSlot();
+    if (!slot) return;
+    Ring& ring = *slot->ring;
+    const uint64_t i = ring.claimed.load(std::memory_order_relaxed);
+    ring.claimed.store(i + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Event& e = ring.events[i % EVENTS_PER_THREAD];
+    e.name.store(name, std::memory_order_relaxed);
+    e.begin.store(beginNs, std::memory_order_relaxed);
+    e.end.store(endNs, std::memory_order_relaxed);
+    e.tid.store(slot->tid, std::memory_order_relaxed);
+    ring.committed.store(i + 1, std::memory_order_release);
+}
+
+bool dump(const std::string& path) {
+    std::vector<Copied> events;
+    uint64_t origin = UINT64_MAX;
+    for (Ring& ring : rings) {
+        const uint64_t head = ring.committed.load(std::memory_order_acquire);
+        const uint64_t first =
+            head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+        const size_t base = events.size();
+        for (uint64_t i = first; i < head; ++i) {
+            const Event& e = ring.events[i % EVENTS_PER_THREAD];
+            events.push_back({e.name.load(std::memory_order_relaxed),
+                              e.begin.load(std::memory_order_relaxed),
+                              e.end.load(std::memory_order_relaxed),
+                              e.tid.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 复制期间写者已认领的序号覆写了更早的槽位，这些副本不可信
+        const uint64_t claimed = ring.claimed.load(std::memory_order_relaxed);
+        const uint64_t valid =
+            claimed > EVENTS_PER_THREAD ? claimed - EVENTS_PER_THREAD : 0;
+        if (valid > first) {
+            events.erase(events.begin() + static_cast<std::ptrdiff_t>(base),
+                         events.begin() + static_cast<std::ptrdiff_t>(
+                                              base + std::min(valid - first,
+                                                              head - first)));
+        }
+    }
+    std::vector<uint32_t> tids;
+    for (const Copied& c : events) {
+        origin = std::min(origin, c.begin);
+        tids.push_back(c.tid);
+    }
+    if (origin == UINT64_MAX) origin = 0;
+    std::sort(tids.begin(), tids.end());
+    tids.erase(std::unique(tids.begin(), tids.end()), tids.end());
+
+    std::FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp) return false;
+    std::fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    auto separator = [&] {
+        std::fputs(first ? "\n" : ",\n", fp);
+        first = false;
+    };
+    for (uint32_t tid : tids) {
+        if (const char* name = nameOf(tid)) {
+            separator();
+            std::fprintf(fp,
+                         "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                         "\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                         tid, name);
+        }
+    }
+    for (const Copied& c : events) {
+        if (!c.name) continue;
+        separator();
+        // 时间单位为微秒，相对最早事件
+        std::fprintf(fp,
+                     "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%.3f,\"dur\":%.3f}",
+                     c.name, c.tid, (c.begin - origin) * 1e-3,
+                     (c.end - c.begin) * 1e-3);
+    }
+    std::fprintf(fp, "\n]}\n");
+    return std::fclose(fp) == 0;
+}
+
+#else
+
+void setThreadName(const char*) {}
+
+uint32_t threadId() { return 0; }
+
+void releaseThread(uint32_t) {}
+
+void releaseThread() {}
+
+void record(const char*, uint64_t, uint64_t) {}
+
+bool dump(const std::string&) { return false; }
+
+#endif
+
+}  // namespace trace
+}  // namespace binaural
@@ -0,0 +1,75 @@
+#include "binaural/voiceBank.hpp"
+#include <algorithm>
+
+namespace binaural {
+
+void VoiceBank::reserve(size_t maxVoices) {
+    for (FloatArray* column : {&pitch, &volume}) {
+        column->reserve(maxVoices);
+    }
+    for (DoubleArray* column : {&beat, &beatSlope, &phaseA, &phaseB,
+                                &prevPhaseA_, &prevPhaseB_}) {
+        column->reserve(maxVoices);
+    }
+    slotOfVoice_.reserve(maxVoices);
+    voiceOfSlot_.reserve(maxVoices);
+}
+
+void VoiceBank::setAllBeats(float hz) {
+    std::fill(beat.begin(), beat.end(), hz);
+    std::fill(beatSlope.begin(), beatSlope.end(), 0.0);
+}
+
+void VoiceBank::glideAllBeats(float hz, float frames) {
+    for (size_t s = 0; s < size(); ++s) {
+        beatSlope[s] = (hz - beat[s]) / frames;
+    }
+}
+
+void VoiceBank::reanchor(double frames, double sampleRate) {
+    for (size_t s = 0; s < size(); ++s) {
+        const Oscillators osc = oscillators(s);
+        phaseA[s] = phase::wrap(
+            phaseA[s] + phase::cycles(osc.hzA, osc.slopeA, frames, sampleRate));
+        phaseB[s] = phase::wrap(
+            phaseB[s] + phase::cycles(osc.hzB, osc.slopeB, frames, sampleRate));
+        beat[s] += osc.slope * frames;
+    }
+}
+
+void VoiceBank::beginRebuild(size_t n) {
+    // 旧相位按 voice 下标展开，供 placeVoice 取回
+    prevCount_ = size();
+    prevPhaseA_.resize(prevCount_);
+    prevPhaseB_.resize(prevCount_);
+    for (size_t s = 0; s < prevCount_; ++s) {
+        const size_t j = voiceOfSlot_[s];
+        prevPhaseA_[j] = phaseA[s];
+        prevPhaseB_[j] = phaseB[s];
+    }
+
+    for (FloatArray* column : {&pitch, &volume}) {
+        column->resize(n);
+    }
+    for (DoubleArray* column : {&beat, &beatSlope, &phaseA, &phaseB}) {
+        column->resize(n);
+    }
+    slotOfVoice_.resize(n);
+    voiceOfSlot_.resize(n);
+    binauralCount_ = 0;
+    audibleCount_ = 0;
+}
+
+void VoiceBank::placeVoice(size_t voice, size_t slot,
+                           const BinauralBeatVoice& v, float pitchHz) {
+    slotOfVoice_[voice] = static_cast<uint32_t>(slot);
+    voiceOfSlot_[slot] = static_cast<uint32_t>(voice);
+    pitch[slot] = pitchHz;
+    beat[slot] = v.freqStart;
+    beatSlope[slot] = 0.0;
+    volume[slot] = v.volume;
+    phaseA[slot] = voice < prevCount_ ? prevPhaseA_[voice] : 0.0;
+    phaseB[slot] = voice < prevCount_ ? prevPhaseB_[voice] : 0.0;
+}
+
+}  // namespace binaural
@@ -1,6 +1,6 @@
 #include "binaural/wavDriver.hpp"
-#include <fstream>
-#include <vector>
+#include "binaural/wavWriter.hpp"
+#include <algorithm>
 
 namespace binaural {
 
@@ -17,44 +17,35 @@ void WavFileDriver::stop() { running_ = false; }
 
 bool WavFileDriver::isRunning() const { return running_; }
 
-void WavFileDriver::writeToFile(const std::string& path, float durationSec) {
-    std::ofstream f(path, std::ios::binary);
-    if (!f) return;
-
-    std::vector<int16_t> buf(bufferFrames_ * 2);
-    const int totalFrames = static_cast<int>(durationSec * sampleRate_);
-    const int numChunks = (totalFrames + bufferFrames_ - 1) / bufferFrames_;
-
-    std::vector<int16_t> allSamples;
-    allSamples.reserve(totalFrames * 2);
-    for (int i = 0; i < numChunks; ++i) {
-        callback_(buf);
-        for (int16_t s : buf) allSamples.push_back(s);
-    }
-
-    const int dataSize = static_cast<int>(allSamples.size()) * 2;
-    const int fileSize = 36 + dataSize;
-
-    f.write("RIFF", 4);
-    f.write(reinterpret_cast<const char*>(&fileSize), 4);
-    f.write("WAVE", 4);
-    f.write("fmt ", 4);
-    const int fmtLen = 16;
-    f.write(reinterpret_cast<const char*>(&fmtLen), 4);
-    const int16_t audioFormat = 1;
-    f.write(reinterpret_cast<const char*>(&audioFormat), 2);
-    const int16_t numChannels = 2;
-    f.write(reinterpret_cast<const char*>(&numChannels), 2);
-    f.write(reinterpret_cast<const char*>(&sampleRate_), 4);
-    const int byteRate = sampleRate_ * 4;
-    f.write(reinterpret_cast<const char*>(&byteRate), 4);
-    const int16_t blockAlign = 4;
-    f.write(reinterpret_cast<const char*>(&blockAlign), 2);
-    const int16_t bitsPerSample = 16;
-    f.write(reinterpret_cast<const char*>(&bitsPerSample), 2);
-    f.write("data", 4);
-    f.write(reinterpret_cast<const char*>(&dataSize), 4);
-    f.write(reinterpret_cast<const char*>(allSamples.data()), dataSize);
+namespace {
+// 流水线每块的回调 buffer 数
+constexpr size_t BUFFERS_PER_BLOCK = 256;
+}  // namespace
+
+bool WavFileDriver::writeToFile(const std::string& path, float durationSec,
+                                ExportStats* stats) {
+    WavWriter writer;
+    if (!writer.open(path, sampleRate_)) return false;
+
+    const size_t bufferFrames = static_cast<size_t>(bufferFrames_);
+    const uint64_t totalFrames = static_cast<uint64_t>(
+        static_cast<double>(durationSec) * sampleRate_);
+    uint64_t remaining = (totalFrames + bufferFrames_ - 1) / bufferFrames_;
+    WritePipeline pipeline(BUFFERS_PER_BLOCK * bufferFrames_);
+    const bool ok = pipeline.run(
+        [&](int16_t* out, size_t) -> size_t {
+            const size_t count = static_cast<size_t>(
+                std::min<uint64_t>(remaining, BUFFERS_PER_BLOCK));
+            for (size_t i = 0; i < count; ++i)
+                callback_(out + i * bufferFrames * 2, bufferFrames);
+            remaining -= count;
+            return count * bufferFrames;
+        },
+        [&writer](const int16_t* samples, size_t frames) {
+            return writer.write(samples, frames);
+        });
+    if (stats) *stats = pipeline.stats();
+    return writer.close() && ok;
 }
 
 }  // namespace binaural
@@ -0,0 +1,222 @@
+#include "binaural/wavWriter.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace binaural {
+
+namespace {
+constexpr int BITS_PER_SAMPLE = 16;
+constexpr uint64_t DS64_SIZE = 28;
+constexpr uint64_t MAX_RIFF_SIZE = 0xFFFFFFFFu;
+// O_DIRECT 要求的偏移与长度对齐
+constexpr size_t DIRECT_ALIGN = 4096;
+
+// 小端写入，与主机字节序无关；返回写入后的位置
+char* putLE(char* p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) p[i] = static_cast<char>(v >> (8 * i));
+    return p + bytes;
+}
+
+char* putTag(char* p, const char* tag) {
+    std::memcpy(p, tag, 4);
+    return p + 4;
+}
+
+uint64_t dataBytesOf(int channels, uint64_t frames) {
+    return frames * static_cast<uint64_t>(channels) * sizeof(int16_t);
+}
+}  // namespace
+
+bool isRf64Size(int channels, uint64_t frames) {
+    return WAV_HEADER_SIZE - 8 + dataBytesOf(channels, frames) > MAX_RIFF_SIZE;
+}
+
+// RIFF 头 12 + JUNK/ds64 块 8 + 28 + fmt 块 8 + 16 + data 块头 8
+void makeWavHeader(char* out, int sampleRate, int channels, uint64_t frames) {
+    const uint64_t dataBytes = dataBytesOf(channels, frames);
+    const uint64_t riffSize = WAV_HEADER_SIZE - 8 + dataBytes;
+    const bool rf64 = isRf64Size(channels, frames);
+    const int blockAlign = channels * BITS_PER_SAMPLE / 8;
+
+    char* p = putTag(out, rf64 ? "RF64" : "RIFF");
+    p = putLE(p, rf64 ? MAX_RIFF_SIZE : riffSize, 4);
+    p = putTag(p, "WAVE");
+    // 非 RF64 时为同样大小的 JUNK 占位，便于流式写入后就地改写
+    p = putTag(p, rf64 ? "ds64" : "JUNK");
+    p = putLE(p, DS64_SIZE, 4);
+    if (rf64) {
+        p = putLE(p, riffSize, 8);
+        p = putLE(p, dataBytes, 8);
+        p = putLE(p, frames, 8);
+        p = putLE(p, 0, 4);  // 无额外块长度表
+    } else {
+        std::memset(p, 0, DS64_SIZE);
+        p += DS64_SIZE;
+    }
+    p = putTag(p, "fmt ");
+    p = putLE(p, 16, 4);
+    p = putLE(p, 1, 2);  // PCM
+    p = putLE(p, static_cast<uint64_t>(channels), 2);
+    p = putLE(p, static_cast<uint64_t>(sampleRate), 4);
+    p = putLE(p, static_cast<uint64_t>(sampleRate) * blockAlign, 4);
+    p = putLE(p, static_cast<uint64_t>(blockAlign), 2);
+    p = putLE(p, BITS_PER_SAMPLE, 2);
+    p = putTag(p, "data");
+    putLE(p, rf64 ? MAX_RIFF_SIZE : dataBytes, 4);
+}
+
+WavWriter::~WavWriter() {
+    if (isOpen()) close();
+}
+
+bool WavWriter::isOpen() const { return fd_ >= 0 || file_.is_open(); }
+
+bool WavWriter::open(const std::string& path, int sampleRate, int channels,
+                     bool directIo) {
+    if (isOpen()) close();
+    path_ = path;
+    sampleRate_ = sampleRate;
+    channels_ = channels;
+    framesWritten_ = 0;
+    failed_ = false;
+    staged_ = 0;
+    directOffset_ = 0;
+#ifdef __linux__
+    if (directIo) {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT,
+                     0644);
+        if (fd_ >= 0) staging_.resize(DIRECT_CHUNK);
+    }
+#else
+    (void)directIo;
+#endif
+    directIo_ = fd_ >= 0;
+    if (fd_ < 0) {
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!file_) return false;
+    }
+
+    char header[WAV_HEADER_SIZE];
+    makeWavHeader(header, sampleRate, channels, 0);
+    return writeBytes(header, sizeof(header));
+}
+
+bool WavWriter::write(const int16_t* samples, size_t frames) {
+    if (!isOpen()) return false;
+    // 样本按主机字节序写出（目标平台均为小端）
+    if (!writeBytes(reinterpret_cast<const char*>(samples),
+                    frames * channels_ * sizeof(int16_t)))
+        return false;
+    framesWritten_ += frames;
+    return true;
+}
+
+bool WavWriter::writeBytes(const char* data, size_t n) {
+    if (failed_) return false;
+    if (fd_ < 0) {
+        file_.write(data, static_cast<std::streamsize>(n));
+        if (!file_) failed_ = true;
+        return !failed_;
+    }
+    while (n > 0) {
+        const size_t m = std::min(n, staging_.size() - staged_);
+        std::memcpy(staging_.data() + staged_, data, m);
+        staged_ += m;
+        data += m;
+        n -= m;
+        if (staged_ == staging_.size() && !flushDirect(staged_)) return false;
+    }
+    return true;
+}
+
+// 写出暂存区前 n 字节（DIRECT_ALIGN 的整数倍），剩余部分前移
+bool WavWriter::flushDirect(size_t n) {
+#ifdef __linux__
+    size_t done = 0;
+    while (done < n) {
+        const ssize_t w = ::pwrite(fd_, staging_.data() + done, n - done,
+                                   static_cast<off_t>(directOffset_ + done));
+        if (w <= 0) {
+            failed_ = true;
+            return false;
+        }
+        done += static_cast<size_t>(w);
+    }
+    directOffset_ += n;
+    std::memmove(staging_.data(), staging_.data() + n, staged_ - n);
+    staged_ -= n;
+    return true;
+#else
+    (void)n;
+    return false;
+#endif
+}
+
+bool WavWriter::patchBytes(uint64_t offset, const char* data, size_t n) {
+    if (fd_ < 0) {
+        file_.seekp(static_cast<std::streamoff>(offset));
+        file_.write(data, static_cast<std::streamsize>(n));
+        return static_cast<bool>(file_);
+    }
+#ifdef __linux__
+    return ::pwrite(fd_, data, n, static_cast<off_t>(offset)) ==
+           static_cast<ssize_t>(n);
+#else
+    return false;
+#endif
+}
+
+bool WavWriter::isRf64() const {
+    return isRf64Size(channels_, framesWritten_);
+}
+
+bool WavWriter::close() {
+    if (!isOpen()) return false;
+    bool ok = !failed_;
+#ifdef __linux__
+    if (fd_ >= 0) {
+        // 整块部分仍走 O_DIRECT；不足一块的尾部与头部回填改用普通写入
+        if (ok) ok = flushDirect(staged_ / DIRECT_ALIGN * DIRECT_ALIGN);
+        ::close(fd_);
+        fd_ = ::open(path_.c_str(), O_WRONLY);
+        if (fd_ < 0) return false;
+        if (ok && staged_ > 0) {
+            ok = ::pwrite(fd_, staging_.data(), staged_,
+                          static_cast<off_t>(directOffset_)) ==
+                 static_cast<ssize_t>(staged_);
+        }
+    }
+#endif
+
+    // 头部整体按最终帧数重写，RF64 时 JUNK 占位就地换成 ds64
+    char header[WAV_HEADER_SIZE];
+    makeWavHeader(header, sampleRate_, channels_, framesWritten_);
+    ok = ok && patchBytes(0, header, sizeof(header));
+
+#ifdef __linux__
+    if (fd_ >= 0) {
+        ok = ::close(fd_) == 0 && ok;
+        fd_ = -1;
+        staging_.clear();
+        staging_.shrink_to_fit();
+        return ok;
+    }
+#endif
+    file_.close();
+    return ok && !file_.fail();
+}
+
+bool writeWavFile(const std::string& path, int sampleRate,
+                  const int16_t* samples, size_t frames) {
+    WavWriter writer;
+    if (!writer.open(path, sampleRate)) return false;
+    writer.write(samples, frames);
+    return writer.close();
+}
+
+}  // namespace binaural
@@ -1,28 +1,61 @@
 #include "binaural/waveformBuffer.hpp"
+#include "binaural/trace.hpp"
+#include <algorithm>
 
 namespace binaural {
 
-WaveformBuffer::WaveformBuffer(size_t capacity) : capacity_(capacity) {
-    bufL_.resize(capacity, 0.f);
-    bufR_.resize(capacity, 0.f);
-}
+WaveformBuffer::WaveformBuffer(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)),
+      bufL_(new std::atomic<float>[capacity_]()),
+      bufR_(new std::atomic<float>[capacity_]()) {}
 
-void WaveformBuffer::push(float sampleL, float sampleR) {
-    std::lock_guard lock(mutex_);
-    bufL_[writeIdx_] = sampleL;
-    bufR_[writeIdx_] = sampleR;
-    writeIdx_ = (writeIdx_ + 1) % capacity_;
+void WaveformBuffer::pushBlock(const float* l, const float* r, size_t n) {
+    const uint64_t begin = claimed_.load(std::memory_order_relaxed);
+    const uint64_t end = begin + n;
+    // 先公布将要覆写的范围，读者据此丢弃复制期间可能被改写的帧
+    claimed_.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const size_t skip = n > capacity_ ? n - capacity_ : 0;
+    size_t idx = static_cast<size_t>((begin + skip) % capacity_);
+    for (size_t i = skip; i < n; ++i) {
+        bufL_[idx].store(l[i], std::memory_order_relaxed);
+        bufR_[idx].store(r[i], std::memory_order_relaxed);
+        if (++idx == capacity_) idx = 0;
+    }
+    committed_.store(end, std::memory_order_release);
 }
 
-void WaveformBuffer::getSamples(std::vector<float>& outL,
-                               std::vector<float>& outR) const {
-    std::lock_guard lock(mutex_);
+bool WaveformBuffer::getSamples(std::vector<float>& outL,
+                                std::vector<float>& outR) const {
+    BINAURAL_TRACE_SCOPE("waveform snapshot");
     outL.resize(capacity_);
     outR.resize(capacity_);
-    for (size_t i = 0; i < capacity_; ++i) {
-        size_t idx = (writeIdx_ + i) % capacity_;
-        outL[i] = bufL_[idx];
-        outR[i] = bufR_[idx];
+    const uint64_t cap = capacity_;
+    for (int attempt = 0;; ++attempt) {
+        const uint64_t end = committed_.load(std::memory_order_acquire);
+        // 快照覆盖 [end - cap, end)；序号为负（尚未写到）的部分为 0
+        const uint64_t first = end > cap ? end - cap : 0;
+        const size_t zeros = static_cast<size_t>(cap - (end - first));
+        std::fill(outL.begin(), outL.begin() + zeros, 0.f);
+        std::fill(outR.begin(), outR.begin() + zeros, 0.f);
+        size_t idx = static_cast<size_t>(first % cap);
+        for (size_t i = zeros; i < capacity_; ++i) {
+            outL[i] = bufL_[idx].load(std::memory_order_relaxed);
+            outR[i] = bufR_[idx].load(std::memory_order_relaxed);
+            if (++idx == capacity_) idx = 0;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 序号低于 claimed - cap 的帧可能已被新数据覆写
+        const uint64_t claimed = claimed_.load(std::memory_order_relaxed);
+        const uint64_t valid = claimed > cap ? claimed - cap : 0;
+        if (valid <= first) return true;
+        if (attempt + 1 == MAX_READ_ATTEMPTS) {
+            const size_t torn = static_cast<size_t>(
+                std::min<uint64_t>(valid - first, end - first));
+            std::fill(outL.begin() + zeros, outL.begin() + zeros + torn, 0.f);
+            std::fill(outR.begin() + zeros, outR.begin() + zeros + torn, 0.f);
+            return false;
+        }
     }
 }
 
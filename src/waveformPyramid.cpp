@@ -0,0 +1,152 @@
+#include "binaural/waveformPyramid.hpp"
+#include "binaural/trace.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace binaural {
+
+namespace {
+int64_t floorDiv(int64_t a, int64_t b) {
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+int64_t ceilDiv(int64_t a, int64_t b) { return -floorDiv(-a, b); }
+}  // namespace
+
+void WaveformPyramid::Accumulator::reset() {
+    minL = minR = std::numeric_limits<float>::infinity();
+    maxL = maxR = -std::numeric_limits<float>::infinity();
+    count = 0;
+}
+
+WaveformPyramid::WaveformPyramid(size_t binsPerLevel, int levels,
+                                 uint64_t baseBinFrames)
+    : bins_(std::max<size_t>(binsPerLevel, 1)) {
+    levels = std::max(levels, 1);
+    uint64_t frames = std::max<uint64_t>(baseBinFrames, 1);
+    for (int k = 0; k < levels; ++k, frames *= FACTOR)
+        binFrames_.push_back(frames);
+    peaks_.reset(new std::atomic<float>[bins_ * binFrames_.size() * 4]());
+    acc_.resize(binFrames_.size());
+    for (Accumulator& a : acc_) a.reset();
+    emitted_.assign(binFrames_.size(), 0);
+}
+
+void WaveformPyramid::emit(int level) {
+    for (;;) {
+        Accumulator& a = acc_[level];
+        std::atomic<float>* p = bin(level, emitted_[level]++);
+        p[0].store(a.minL, std::memory_order_relaxed);
+        p[1].store(a.maxL, std::memory_order_relaxed);
+        p[2].store(a.minR, std::memory_order_relaxed);
+        p[3].store(a.maxR, std::memory_order_relaxed);
+        if (level + 1 == levels()) {
+            a.reset();
+            return;
+        }
+        Accumulator& up = acc_[level + 1];
+        up.minL = std::min(up.minL, a.minL);
+        up.maxL = std::max(up.maxL, a.maxL);
+        up.minR = std::min(up.minR, a.minR);
+        up.maxR = std::max(up.maxR, a.maxR);
+        a.reset();
+        if (++up.count < FACTOR) return;
+        ++level;
+    }
+}
+
+void WaveformPyramid::pushFrame(float l, float r) {
+    Accumulator& a = acc_[0];
+    a.minL = std::min(a.minL, l);
+    a.maxL = std::max(a.maxL, l);
+    a.minR = std::min(a.minR, r);
+    a.maxR = std::max(a.maxR, r);
+    if (++a.count == binFrames_[0]) emit(0);
+}
+
+void WaveformPyramid::pushBlock(const float* l, const float* r, size_t n) {
+    const uint64_t end = claimed_.load(std::memory_order_relaxed) + n;
+    claimed_.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < n; ++i) pushFrame(l[i], r[i]);
+    committed_.store(end, std::memory_order_release);
+}
+
+void WaveformPyramid::pushInterleaved(const int16_t* samples, size_t frames) {
+    const uint64_t end = claimed_.load(std::memory_order_relaxed) + frames;
+    claimed_.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < frames; ++i) {
+        pushFrame(samples[2 * i] * (1.f / 32768.f),
+                  samples[2 * i + 1] * (1.f / 32768.f));
+    }
+    committed_.store(end, std::memory_order_release);
+}
+
+// 最粗的、每列仍至少一个 bin 的层；该层历史不够长时继续取更粗的层
+int WaveformPyramid::levelFor(uint64_t windowFrames, size_t columns) const {
+    const uint64_t perColumn = windowFrames / std::max<size_t>(columns, 1);
+    int level = 0;
+    while (level + 1 < levels() && binFrames_[level + 1] <= perColumn) ++level;
+    while (level + 1 < levels() && binFrames_[level] * bins_ < windowFrames)
+        ++level;
+    return level;
+}
+
+bool WaveformPyramid::readEnvelope(uint64_t windowFrames, PeakColumn* out,
+                                   size_t columns, PeakWindow* window) const {
+    BINAURAL_TRACE_SCOPE("waveform envelope");
+    if (columns == 0) return true;
+    windowFrames = std::max<uint64_t>(windowFrames, 1);
+    const int level = levelFor(windowFrames, columns);
+    const int64_t binLen = static_cast<int64_t>(binFrames_[level]);
+    const int64_t span = static_cast<int64_t>(windowFrames);
+    const int64_t cols = static_cast<int64_t>(columns);
+
+    for (int attempt = 0;; ++attempt) {
+        const uint64_t committed = committed_.load(std::memory_order_acquire);
+        const int64_t done = static_cast<int64_t>(committed) / binLen;
+        const int64_t oldest =
+            std::max<int64_t>(done - static_cast<int64_t>(bins_), 0);
+        const int64_t end = done * binLen;
+        int64_t firstRead = done;
+        for (int64_t c = 0; c < cols; ++c) {
+            const int64_t from = end - span + c * span / cols;
+            const int64_t to = end - span + (c + 1) * span / cols;
+            int64_t b0 = floorDiv(from, binLen);
+            int64_t b1 = std::max(b0 + 1, ceilDiv(to, binLen));
+            b0 = std::max(b0, oldest);
+            b1 = std::min(b1, done);
+            PeakColumn col;
+            if (b0 < b1) {
+                firstRead = std::min(firstRead, b0);
+                col.minL = col.minR = std::numeric_limits<float>::infinity();
+                col.maxL = col.maxR = -std::numeric_limits<float>::infinity();
+                for (int64_t b = b0; b < b1; ++b) {
+                    const std::atomic<float>* p =
+                        bin(level, static_cast<uint64_t>(b));
+                    col.minL = std::min(col.minL,
+                                        p[0].load(std::memory_order_relaxed));
+                    col.maxL = std::max(col.maxL,
+                                        p[1].load(std::memory_order_relaxed));
+                    col.minR = std::min(col.minR,
+                                        p[2].load(std::memory_order_relaxed));
+                    col.maxR = std::max(col.maxR,
+                                        p[3].load(std::memory_order_relaxed));
+                }
+            }
+            out[c] = col;
+        }
+        if (window) *window = {level, binFrames_[level],
+                               static_cast<uint64_t>(end)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 序号低于 claimed 所在 bin - bins 的 bin 可能已被新数据覆写
+        const int64_t claimed = static_cast<int64_t>(
+            claimed_.load(std::memory_order_relaxed));
+        if (claimed / binLen - static_cast<int64_t>(bins_) <= firstRead)
+            return true;
+        if (attempt + 1 == MAX_READ_ATTEMPTS) return false;
+    }
+}
+
+}  // namespace binaural
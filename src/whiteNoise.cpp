@@ -0,0 +1,82 @@
+#include "binaural/whiteNoise.hpp"
+#include "binaural/oscillatorKernels.hpp"
+#include <algorithm>
+
+#if defined(__GNUC__)
+#define BINAURAL_ALWAYS_INLINE inline __attribute__((always_inline))
+#if defined(__x86_64__) || defined(__i386__)
+#define BINAURAL_NOISE_AVX2 1
+#endif
+#else
+#define BINAURAL_ALWAYS_INLINE inline
+#endif
+
+namespace binaural {
+
+namespace noise {
+
+namespace {
+
+// 段内计数器高位为常量，循环体只有 32 位整数运算，编译器可直接向量化
+BINAURAL_ALWAYS_INLINE void uniformRun(uint32_t k, uint32_t lo, float* out,
+                                       size_t m) {
+    for (size_t i = 0; i < m; ++i) {
+        uint32_t x = (lo + static_cast<uint32_t>(i)) ^ k;
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        x *= 0x846CA68Bu;
+        x ^= x >> 16;
+        out[i] = static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+void uniformRunDefault(uint32_t k, uint32_t lo, float* out, size_t m) {
+    uniformRun(k, lo, out, m);
+}
+
+#if defined(BINAURAL_NOISE_AVX2)
+// SSE2 没有 32 位整数乘法（pmulld），AVX2 版本快数倍
+__attribute__((target("avx2"))) void uniformRunAvx2(uint32_t k, uint32_t lo,
+                                                    float* out, size_t m) {
+    uniformRun(k, lo, out, m);
+}
+#endif
+
+using UniformRunFn = void (*)(uint32_t, uint32_t, float*, size_t);
+
+UniformRunFn selectUniformRun() {
+#if defined(BINAURAL_NOISE_AVX2)
+    if (kernels::detectSimdLevel() == SimdLevel::Avx2) return uniformRunAvx2;
+#endif
+    return uniformRunDefault;
+}
+
+// 静态初始化时选定：音频线程上不经过函数内静态变量的首次初始化与守卫
+const UniformRunFn uniformRunImpl = selectUniformRun();
+
+}  // namespace
+
+void uniformBlock(uint32_t key, uint64_t counter, float* out, size_t n) {
+    while (n > 0) {
+        // 计数器低 32 位回绕处分段
+        const uint64_t toWrap = (uint64_t{1} << 32) - (counter & 0xFFFFFFFFu);
+        const size_t m = static_cast<size_t>(std::min<uint64_t>(n, toWrap));
+        const uint32_t k =
+            key ^ (static_cast<uint32_t>(counter >> 32) * 0x9E3779B9u);
+        uniformRunImpl(k, static_cast<uint32_t>(counter), out, m);
+        out += m;
+        counter += m;
+        n -= m;
+    }
+}
+
+}  // namespace noise
+
+void WhiteNoise::generate(float* out, size_t n) {
+    noise::uniformBlock(key_, counter_, out, n);
+    for (size_t i = 0; i < n; ++i) out[i] = out[i] * 2.0f - 1.0f;
+    counter_ += n;
+}
+
+}  // namespace binaural
@@ -0,0 +1,103 @@
+#include "binaural/writePipeline.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace binaural {
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+}  // namespace
+
+WritePipeline::WritePipeline(size_t blockFrames, int numBlocks)
+    : blockFrames_(std::max<size_t>(blockFrames, 1)),
+      blocks_(static_cast<size_t>(std::max(numBlocks, 2))) {
+    for (Block& b : blocks_) b.resize(blockFrames_ * 2);
+}
+
+bool WritePipeline::run(const Fill& fill, const Sink& sink) {
+    stats_ = {};
+    const auto start = Clock::now();
+
+    // 空闲块与待写块两个队列，块按填充顺序写出
+    struct Filled {
+        size_t block;
+        size_t frames;
+    };
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> freeBlocks;
+    std::deque<Filled> filled;
+    bool done = false;
+    bool failed = false;
+    for (size_t i = 0; i < blocks_.size(); ++i) freeBlocks.push_back(i);
+
+    std::thread writer([&]() {
+        for (;;) {
+            Filled job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                const auto t0 = Clock::now();
+                cv.wait(lock, [&] { return !filled.empty() || done; });
+                stats_.writeStallSec += secondsSince(t0);
+                if (filled.empty()) return;
+                job = filled.front();
+                filled.pop_front();
+            }
+            const auto t0 = Clock::now();
+            const bool ok = sink(blocks_[job.block].data(), job.frames);
+            stats_.writeSec += secondsSince(t0);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ok) {
+                    stats_.bytes += job.frames * 2 * sizeof(int16_t);
+                } else {
+                    failed = true;
+                }
+                freeBlocks.push_back(job.block);
+            }
+            cv.notify_all();
+            if (!ok) return;
+        }
+    });
+
+    for (;;) {
+        size_t block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const auto t0 = Clock::now();
+            cv.wait(lock, [&] { return !freeBlocks.empty() || failed; });
+            stats_.renderStallSec += secondsSince(t0);
+            if (failed) break;
+            block = freeBlocks.front();
+            freeBlocks.pop_front();
+        }
+        const auto t0 = Clock::now();
+        const size_t frames = fill(blocks_[block].data(), blockFrames_);
+        stats_.renderSec += secondsSince(t0);
+        if (frames == 0) break;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            filled.push_back({block, frames});
+        }
+        cv.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    cv.notify_all();
+    writer.join();
+
+    stats_.totalSec = secondsSince(start);
+    return !failed;
+}
+
+}  // namespace binaural